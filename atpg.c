@@ -0,0 +1,277 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "type.h"
+#include "netlist.h"
+#include "evsim.h"
+#include "atpg.h"
+
+/* 3-valued gate over the good or faulty halves, 2 is X */
+static int eval3(int t, const unsigned char *v, const int *p, const int *e, int half)
+{
+	int x, y, any = 0;
+	switch(t){
+		case BRCH:
+		case NOT:
+			x = half ? L5F(v[*p]) : L5G(v[*p]);
+			return t == NOT && x != 2 ? !x : x;
+		case XOR:
+			for(y = 0; p < e; p++){
+				x = half ? L5F(v[*p]) : L5G(v[*p]);
+				if(x == 2) return 2;
+				y ^= x;
+			}
+			return y;
+		case AND:
+		case NAND:
+			for(; p < e; p++){
+				x = half ? L5F(v[*p]) : L5G(v[*p]);
+				if(x == 0) return t == NAND;
+				any |= x == 2;
+			}
+			return any ? 2 : t == AND;
+		case OR:
+		case NOR:
+			for(; p < e; p++){
+				x = half ? L5F(v[*p]) : L5G(v[*p]);
+				if(x == 1) return t == OR;
+				any |= x == 2;
+			}
+			return any ? 2 : t == NOR;
+	}
+	return 2;
+}
+
+/* value of node i from its fan-ins, the PI choice and the fault */
+static int eval5(const struct atpg *a, int i)
+{
+	const CNET *c = a->c;
+	const int *p = c->fi + c->fioff[i];
+	const int *e = c->fi + c->fioff[i + 1];
+	int g, f;
+
+	if(c->type[i] == IPT || (a->cut && a->cut[i])) g = f = a->pin[i] == LX ? 2 : a->pin[i];
+	else{
+		g = eval3(c->type[i], a->v, p, e, 0);
+		f = eval3(c->type[i], a->v, p, e, 1);
+	}
+	if(i == a->fnode) f = a->fval;
+	if(g == 2 || f == 2) return LX;
+	if(g == f) return g;
+	return g ? LD : LDB;
+}
+
+/* put gate g in or out of the D-frontier */
+static void dfupd(struct atpg *a, int g)
+{
+	const CNET *c = a->c;
+	int k, in = 0;
+	if(a->v[g] == LX)
+		for(k = c->fioff[g]; k < c->fioff[g + 1] && !in; k++)
+			in = ISD(a->v[c->fi[k]]);
+	if(in && a->dpos[g] < 0){
+		a->dpos[g] = a->ndfr;
+		a->dfr[a->ndfr++] = g;
+	}
+	else if(!in && a->dpos[g] >= 0){
+		k = a->dfr[--a->ndfr];
+		a->dfr[a->dpos[g]] = k;
+		a->dpos[k] = a->dpos[g];
+		a->dpos[g] = -1;
+	}
+}
+
+/* node i changed, fix the frontier around it */
+static void around(struct atpg *a, int i)
+{
+	const CNET *c = a->c;
+	int k;
+	dfupd(a, i);
+	for(k = c->fooff[i]; k < c->fooff[i + 1]; k++) dfupd(a, c->fo[k]);
+}
+
+static void trail(struct atpg *a, int code, int old)
+{
+	if(a->ntrail == a->tcap){
+		a->tcap = a->tcap ? 2 * a->tcap : 1024;
+		a->tnode = (int *) realloc(a->tnode, a->tcap * sizeof(int));
+		a->tval = (unsigned char *) realloc(a->tval, a->tcap);
+	}
+	a->tnode[a->ntrail] = code;
+	a->tval[a->ntrail++] = old;
+}
+
+static void setv(struct atpg *a, int i, int x)
+{
+	if(a->ispo[i]) a->ndpo += ISD(x) - ISD(a->v[i]);
+	trail(a, 2 * i, a->v[i]);
+	a->v[i] = x;
+	around(a, i);
+}
+
+/* evaluate the queued gates, queueing the fan-outs of every change */
+static void imply(struct atpg *a)
+{
+	int i, x;
+	while((i = evq_pop(&a->q)) >= 0){
+		x = eval5(a, i);
+		if(x == a->v[i]) continue;
+		setv(a, i, x);
+		evq_fanout(&a->q, i);
+	}
+	a->q.lo = a->c->nlev;
+}
+
+void atpg_init(struct atpg *a, const CNET *c)
+{
+	int i;
+	memset(a, 0, sizeof(*a));
+	a->c = c;
+	a->v = (unsigned char *) malloc(c->n);
+	a->pin = (unsigned char *) malloc(c->n);
+	a->dfr = (int *) malloc((c->n + 1) * sizeof(int));
+	a->dpos = (int *) malloc(c->n * sizeof(int));
+	a->stamp = (int *) calloc(c->n, sizeof(int));
+	a->ispo = (unsigned char *) calloc(c->n, 1);
+	for(i = 0; i < c->npo; i++) a->ispo[c->po[i]] = 1;
+	evq_init(&a->q, c);
+	a->fnode = -1;
+}
+
+void atpg_free(struct atpg *a)
+{
+	free(a->v);
+	free(a->pin);
+	free(a->tnode);
+	free(a->tval);
+	free(a->dfr);
+	free(a->dpos);
+	free(a->stamp);
+	free(a->ispo);
+	evq_free(&a->q);
+}
+
+/*-----------------------------------------------------------------------
+input: state, FArr fault id
+output: nothing
+called by: podem, fan
+description: start a new target, every PI free and every node X. The
+  trail starts empty, so atpg_undo(a, 0) returns here.
+author: Li
+-----------------------------------------------------------------------*/
+void atpg_fault(struct atpg *a, int f)
+{
+	const CNET *c = a->c;
+	memset(a->v, LX, c->n);
+	memset(a->pin, LX, c->n);
+	memset(a->dpos, -1, c->n * sizeof(int));
+	a->ndfr = a->ndpo = a->ntrail = 0;
+	a->fnode = f / 2;
+	a->fval = f % 2;
+}
+
+/* assign good value b to PI (or cut) node i and imply it */
+void atpg_pi(struct atpg *a, int i, int b)
+{
+	trail(a, 2 * i + 1, a->pin[i]);
+	a->pin[i] = b;
+	evq_push(&a->q, i);
+	imply(a);
+}
+
+/* roll the trail back to mark */
+void atpg_undo(struct atpg *a, int mark)
+{
+	int i, code;
+	while(a->ntrail > mark){
+		code = a->tnode[--a->ntrail];
+		i = code >> 1;
+		if(code & 1){
+			a->pin[i] = a->tval[a->ntrail];
+			continue;
+		}
+		if(a->ispo[i]) a->ndpo += ISD(a->tval[a->ntrail]) - ISD(a->v[i]);
+		a->v[i] = a->tval[a->ntrail];
+		around(a, i);
+	}
+}
+
+/* 1 if a path of X nodes leads from gate g to a PO */
+static int xpath(struct atpg *a, int g)
+{
+	const CNET *c = a->c;
+	int k;
+	if(a->ispo[g]) return 1;
+	if(a->stamp[g] == a->epoch) return 0;
+	a->stamp[g] = a->epoch;
+	for(k = c->fooff[g]; k < c->fooff[g + 1]; k++)
+		if(a->v[c->fo[k]] == LX && xpath(a, c->fo[k])) return 1;
+	return 0;
+}
+
+int atpg_xpath(struct atpg *a, int g)
+{
+	a->epoch++;
+	return xpath(a, g);
+}
+
+/* 1 if a learned implication of "node i has good value b" meets the
+   opposite good value somewhere; branches and inverters are followed
+   back to the gate that drives them, where the table has its entries */
+int atpg_lconf(const struct atpg *a, int i, int b)
+{
+	const CNET *c = a->c;
+	int k, x;
+	if(c->lnoff == NULL) return 0;
+	while(c->type[i] == BRCH || c->type[i] == NOT){
+		b ^= c->type[i] == NOT;
+		i = c->fi[c->fioff[i]];
+	}
+	for(k = c->lnoff[2 * i + b]; k < c->lnoff[2 * i + b + 1]; k++){
+		x = L5G(a->v[c->lrn[k] >> 1]);
+		if(x != 2 && x != (c->lrn[k] & 1)) return 1;
+	}
+	return 0;
+}
+
+/*-----------------------------------------------------------------------
+input: state
+output: 1 if no completion of the current PI values can detect the fault
+called by: podem, fan
+description: the site shows the stuck value, or no D-frontier gate has
+  an X path to a PO while no PO shows the fault yet. With a learned
+  table (learn.c) two values every test must still give are checked
+  against it as well: the site at the opposite of the stuck value, and
+  the X inputs of the only D-frontier gate at the non-controlling value.
+author: Li
+-----------------------------------------------------------------------*/
+int atpg_conflict(struct atpg *a)
+{
+	const CNET *c = a->c;
+	int k, g, t, x;
+	if(a->ndpo) return 0;
+	if(a->v[a->fnode] == a->fval) return 1;
+	if(a->v[a->fnode] == LX) return atpg_lconf(a, a->fnode, !a->fval);
+	for(k = 0; k < a->ndfr; k++)
+		if(atpg_xpath(a, a->dfr[k])) break;
+	if(k == a->ndfr) return 1;
+	if(a->ndfr != 1 || (t = c->type[g = a->dfr[0]]) < OR || t == NOT) return 0;
+	for(k = c->fioff[g]; k < c->fioff[g + 1]; k++){
+		x = c->fi[k];
+		if(a->v[x] == LX && atpg_lconf(a, x, !(t == OR || t == NOR))) return 1;
+	}
+	return 0;
+}
+
+/* PI values as a test cube in Pinput order, 2 for a free PI */
+void atpg_vector(const struct atpg *a, int *vec)
+{
+	int k;
+	for(k = 0; k < a->c->npi; k++)
+		vec[k] = a->pin[a->c->pi[k]] == LX ? 2 : a->pin[a->c->pi[k]] == L1;
+}
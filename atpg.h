@@ -0,0 +1,54 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+/*-----------------------------------------------------------------------
+  5-valued implication for test generation
+
+  Every compiled node holds one of 0, 1, X, D (good 1, faulty 0) and
+  D' (good 0, faulty 1). The PIs carry the good value chosen by the
+  search, every other node is computed from its fan-ins, and the fault
+  site forces the faulty half to the stuck value. Assignments are
+  implied forward with the event queue, only through the gates whose
+  inputs changed, and every change goes on a trail so a decision is
+  undone by rolling the trail back to a mark. The D-frontier (X gates
+  with a D or D' on a fan-in) and the count of POs carrying D or D' are
+  kept up to date on each change, never rescanned.
+-----------------------------------------------------------------------*/
+enum e_l5 {L0, L1, LX, LD, LDB};
+enum e_tstat {T_DETECTED, T_REDUNDANT, T_ABORTED};     /* outcome for one fault */
+
+struct atpg {
+	const CNET *c;
+	unsigned char *v;       /* node values (enum e_l5) */
+	unsigned char *pin;     /* good value of each PI node, LX if free */
+	unsigned char *cut;     /* nodes decided like PIs (FAN headlines), or NULL */
+	int *tnode;             /* trail: 2*node, +1 for a pin change */
+	unsigned char *tval;    /* trail: old value */
+	int ntrail, tcap;
+	int fnode, fval;        /* fault site and stuck value */
+	int *dfr;               /* D-frontier */
+	int *dpos;              /* index in dfr, -1 if not in it */
+	int ndfr;
+	int ndpo;               /* POs with D or D' */
+	unsigned char *ispo;
+	int *stamp;             /* X-path search marks */
+	int epoch;
+	struct evq q;
+};
+
+#define L5G(x) ("\0\1\2\1\0"[x])        /* good half, 2 for X */
+#define L5F(x) ("\0\1\2\0\1"[x])        /* faulty half */
+#define ISD(x) ((x) >= LD)
+
+/*----------------- new function        ----------------------------------*/
+extern void atpg_init(struct atpg *a, const CNET *c);
+extern void atpg_free(struct atpg *a);
+extern void atpg_fault(struct atpg *a, int f);
+extern void atpg_pi(struct atpg *a, int i, int b);
+extern void atpg_undo(struct atpg *a, int mark);
+extern int atpg_xpath(struct atpg *a, int g);
+extern int atpg_lconf(const struct atpg *a, int i, int b);
+extern int atpg_conflict(struct atpg *a);
+extern void atpg_vector(const struct atpg *a, int *vec);
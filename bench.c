@@ -0,0 +1,227 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+/*-----------------------------------------------------------------------
+  benchmark harness
+
+  Built by "make bench" against a copy of readckt.o whose main is
+  renamed, so every phase runs the same code as the commands. For each
+  circuit on the command line the phases read (cold, from the .ckt),
+  read_image (from the .ckb), lev, collapse, logic, atpg (PODEM), dfs
+  and pfs run in that order with fixed settings, and one JSON object per
+  phase goes to stdout, one per line, so two runs can be compared with
+  diff or any JSON tool. The commands' own printing goes to /dev/null.
+
+  Per phase: wall time; vectors and vectors/s for the simulators;
+  faults x vectors/s for DFS and PFS; the peak RSS of the phase (the
+  kernel high-water mark is reset before it, so this needs Linux); and
+  the malloc/calloc/realloc/aligned_alloc calls and bytes of the phase,
+  counted by wrapping them at link time (-Wl,--wrap).
+-----------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/resource.h>
+#include "type.h"
+#include "netlist.h"
+#include "pstore.h"
+#include "lsim.h"
+#include "ckb.h"
+
+#define BENCH_VERSION 1
+#define LOGIC_PATTERNS (1 << 20)
+
+/* readckt.c */
+extern int cread(), lev(), podemS(), DFS_client(), PFS_client();
+extern void initFArr(), freeflist(struct fList **head);
+extern CNET *Cnet;
+extern struct pstore Ptest;
+extern struct fList *Fchead;
+extern int Nnodes, Npi, Npo, Nthreads;
+
+/*----------------------------- allocation counts -----------------------*/
+extern void *__real_malloc(size_t n);
+extern void *__real_calloc(size_t n, size_t m);
+extern void *__real_realloc(void *p, size_t n);
+extern void *__real_aligned_alloc(size_t a, size_t n);
+
+static unsigned long long Nalloc, Balloc;      /* calls and bytes */
+
+#define COUNT(n) (__atomic_fetch_add(&Nalloc, 1, __ATOMIC_RELAXED), \
+	__atomic_fetch_add(&Balloc, (n), __ATOMIC_RELAXED))
+
+void *__wrap_malloc(size_t n)
+{
+	COUNT(n);
+	return __real_malloc(n);
+}
+
+void *__wrap_calloc(size_t n, size_t m)
+{
+	COUNT(n * m);
+	return __real_calloc(n, m);
+}
+
+void *__wrap_realloc(void *p, size_t n)
+{
+	COUNT(n);
+	return __real_realloc(p, n);
+}
+
+void *__wrap_aligned_alloc(size_t a, size_t n)
+{
+	COUNT(n);
+	return __real_aligned_alloc(a, n);
+}
+
+/*----------------------------- one phase --------------------------------*/
+struct phase {
+	const char *name;
+	struct timespec t0;
+	unsigned long long nalloc, balloc;
+	int quiet;              /* saved stdout */
+};
+
+/* reset the peak RSS to the current RSS, 0 if the kernel cannot */
+static int rss_reset()
+{
+	int fd = open("/proc/self/clear_refs", O_WRONLY), ok;
+	if(fd < 0) return 0;
+	ok = write(fd, "5", 1) == 1;
+	close(fd);
+	return ok;
+}
+
+/* peak RSS in kB since the last rss_reset */
+static long rss_peak()
+{
+	char line[256];
+	long kb = -1;
+	FILE *fp = fopen("/proc/self/status", "r");
+	struct rusage ru;
+
+	if(fp){
+		while(fgets(line, sizeof(line), fp))
+			if(sscanf(line, "VmHWM: %ld", &kb) == 1) break;
+		fclose(fp);
+	}
+	if(kb < 0 && getrusage(RUSAGE_SELF, &ru) == 0) kb = ru.ru_maxrss;
+	return kb;
+}
+
+static void start(struct phase *p, const char *name)
+{
+	int fd;
+	p->name = name;
+	fflush(stdout);
+	p->quiet = dup(1);
+	if((fd = open("/dev/null", O_WRONLY)) >= 0){
+		dup2(fd, 1);
+		close(fd);
+	}
+	rss_reset();
+	p->nalloc = Nalloc;
+	p->balloc = Balloc;
+	clock_gettime(CLOCK_MONOTONIC, &p->t0);
+}
+
+/* end the phase and print its line; vectors and faults are 0 if they do
+   not apply */
+static void stop(struct phase *p, const char *ckt, long long vec, long long flt, int first)
+{
+	struct timespec t1;
+	double t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	t = (t1.tv_sec - p->t0.tv_sec) + (t1.tv_nsec - p->t0.tv_nsec) * 1e-9;
+	fflush(stdout);
+	dup2(p->quiet, 1);
+	close(p->quiet);
+	printf("%s{\"circuit\": \"%s\", \"phase\": \"%s\", \"wall_s\": %0.6f",
+		first ? "  " : ", ", ckt, p->name, t);
+	if(vec) printf(", \"vectors\": %lld, \"vectors_per_s\": %0.1f", vec, t > 0 ? vec / t : 0.0);
+	if(flt) printf(", \"faults\": %lld, \"fault_vectors_per_s\": %0.1f", flt,
+		t > 0 ? (double) flt * vec / t : 0.0);
+	printf(", \"peak_rss_kb\": %ld, \"allocs\": %llu, \"alloc_bytes\": %llu}\n",
+		rss_peak(), Nalloc - p->nalloc, Balloc - p->balloc);
+	fprintf(stderr, "%-10s %-10s %10.6f s\n", ckt, p->name, t);
+}
+
+/*-----------------------------------------------------------------------
+input: circuit file
+output: nothing, the phase lines are printed
+called by: main
+description: the settings are fixed: no threads, PODEM with 1000
+  backtracks per fault, LOGIC_PATTERNS counter patterns in 64*lanes
+  words with the binary output thrown away.
+author: Li
+-----------------------------------------------------------------------*/
+static void circuit(const char *ckt, int *first)
+{
+	char cmd[1024], cname[1032];
+	struct phase p;
+	struct lsrc s;
+	struct lsink k;
+	long long n;
+
+	ckb_name(ckt, cname, sizeof(cname));
+	unlink(cname);
+	snprintf(cmd, sizeof(cmd), "%s", ckt);
+	start(&p, "read");
+	cread(cmd);
+	stop(&p, ckt, 0, 0, *first);
+	*first = 0;
+
+	snprintf(cmd, sizeof(cmd), "%s", ckt);
+	start(&p, "read_image");
+	cread(cmd);
+	stop(&p, ckt, 0, 0, 0);
+
+	start(&p, "lev");
+	lev();
+	stop(&p, ckt, 0, 0, 0);
+
+	freeflist(&Fchead->next);
+	start(&p, "collapse");
+	initFArr();
+	stop(&p, ckt, 0, 0, 0);
+
+	ls_count(&s, Npi, 0, 0, LOGIC_PATTERNS);
+	lk_open(&k, "/dev/null", 1 << 22);
+	start(&p, "logic");
+	n = lsim(Cnet, &s, &k, LF_BIN, cnet_lanes());
+	lk_close(&k);
+	stop(&p, ckt, n, 0, 0);
+	ls_close(&s);
+
+	strcpy(cmd, "-b 1000 -t 100");
+	start(&p, "atpg");
+	podemS(cmd);
+	stop(&p, ckt, Ptest.n, 0, 0);
+
+	start(&p, "dfs");
+	DFS_client();
+	stop(&p, ckt, Ptest.n, 2LL * Nnodes, 0);
+
+	start(&p, "pfs");
+	PFS_client();
+	stop(&p, ckt, Ptest.n, 2LL * Nnodes, 0);
+	unlink(cname);
+}
+
+int main(int argc, char **argv)
+{
+	int i, first = 1;
+
+	printf("{\"version\": %d, \"threads\": %d, \"lanes\": %d, \"phases\": [\n",
+		BENCH_VERSION, Nthreads, cnet_lanes());
+	for(i = 1; i < argc; i++) circuit(argv[i], &first);
+	printf("]}\n");
+	return 0;
+}
@@ -0,0 +1,233 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <dlfcn.h>
+#include <sys/stat.h>
+#include "type.h"
+#include "netlist.h"
+#include "ccsim.h"
+
+#define CCFLAGS "-O2 -march=native -shared -fPIC"
+
+static const int cclanes[3] = {1, 4, 8};
+static const char *cctype[3] = {"uint64_t", "v4w", "v8w"};
+
+/* FNV-1a over n bytes */
+static uint64_t fnv(uint64_t h, const void *p, size_t n)
+{
+	const unsigned char *b = (const unsigned char *) p;
+	while(n--){
+		h ^= *b++;
+		h *= 0x100000001b3ULL;
+	}
+	return h;
+}
+
+/* hash h on with the lines of fp that start with one of the keys, all
+   lines if keys is NULL */
+static uint64_t fnvlines(uint64_t h, FILE *fp, const char **keys)
+{
+	char line[4096];
+	int k;
+	if(fp == NULL) return h;
+	while(fgets(line, sizeof(line), fp)){
+		for(k = 0; keys && keys[k]; k++)
+			if(strncmp(line, keys[k], strlen(keys[k])) == 0) break;
+		if(keys == NULL || keys[k]) h = fnv(h, line, strlen(line));
+	}
+	return h;
+}
+
+/*-----------------------------------------------------------------------
+input: netlist, compiler command
+output: hash of everything the generated object depends on
+called by: ccsim
+description: the netlist structure, the compiler command with its
+  --version output and flags, and the CPU that -march=native targets
+  (vendor, model and feature flags of /proc/cpuinfo, or the vector
+  units the compiler runtime reports).
+author: Li
+-----------------------------------------------------------------------*/
+uint64_t ccsim_hash(const CNET *c, const char *cc)
+{
+	static const char *cpukeys[] = {"vendor_id", "cpu family", "model", "flags", "Features",
+		"CPU implementer", "CPU part", NULL};
+	uint64_t h = 0xcbf29ce484222325ULL;
+	int v = CCSIM_VERSION, hw = cnet_lanes();
+	char *cmd;
+	FILE *fp;
+
+	h = fnv(h, &v, sizeof(v));
+	h = fnv(h, &c->n, sizeof(c->n));
+	h = fnv(h, c->type, c->n);
+	h = fnv(h, c->fioff, (c->n + 1) * sizeof(int));
+	h = fnv(h, c->fi, c->nfi * sizeof(int));
+	h = fnv(h, c->levoff, 2 * sizeof(int));
+	h = fnv(h, cc, strlen(cc) + 1);
+	h = fnv(h, CCFLAGS, sizeof(CCFLAGS));
+	cmd = (char *) malloc(strlen(cc) + 32);
+	sprintf(cmd, "%s --version 2>/dev/null", cc);
+	if((fp = popen(cmd, "r"))){
+		h = fnvlines(h, fp, NULL);
+		pclose(fp);
+	}
+	free(cmd);
+	h = fnv(h, &hw, sizeof(hw));
+	if((fp = fopen("/proc/cpuinfo", "r"))){
+		h = fnvlines(h, fp, cpukeys);
+		fclose(fp);
+	}
+	return h;
+}
+
+/*-----------------------------------------------------------------------
+input: room for the path
+output: 1 with the cache directory in dir, 0 if there is no private one
+called by: ccsim
+description: $XDG_CACHE_HOME/readckt, else $HOME/.cache/readckt, made
+  with mode 0700 when missing. It is used only if it is a real directory
+  of this user that nobody else can write, so no one else can plant an
+  object there for COMPILE to load.
+author: Li
+-----------------------------------------------------------------------*/
+static int cachedir(char *dir, size_t n)
+{
+	const char *x = getenv("XDG_CACHE_HOME"), *home = getenv("HOME");
+	struct stat st;
+
+	if(x && *x == '/') snprintf(dir, n, "%s", x);
+	else if(home && *home == '/') snprintf(dir, n, "%s/.cache", home);
+	else return 0;
+	mkdir(dir, 0700);
+	if(strlen(dir) + 16 > n) return 0;
+	strcat(dir, "/readckt");
+	mkdir(dir, 0700);
+	if(lstat(dir, &st) != 0 || !S_ISDIR(st.st_mode)) return 0;
+	return st.st_uid == geteuid() && (st.st_mode & 022) == 0;
+}
+
+/* name is a regular file of this user that only this user can write */
+static int owned(const char *name)
+{
+	struct stat st;
+	if(lstat(name, &st) != 0 || !S_ISREG(st.st_mode)) return 0;
+	return st.st_uid == geteuid() && (st.st_mode & 022) == 0;
+}
+
+/* one statement for gate i */
+static void gate(FILE *fp, const CNET *c, int i)
+{
+	int t = c->type[i], k, neg = t == NOT || t == NOR || t == NAND;
+	const char *op = t == XOR ? " ^ " : t == OR || t == NOR ? " | " : " & ";
+
+	fprintf(fp, "\tv[%d] = %s", i, neg ? "~(" : "");
+	for(k = c->fioff[i]; k < c->fioff[i + 1]; k++)
+		fprintf(fp, "%sv[%d]", k > c->fioff[i] ? op : "", c->fi[k]);
+	fprintf(fp, "%s;\n", neg ? ")" : "");
+}
+
+/* the C source of ccsim1, ccsim4 and ccsim8, 0 if it cannot be written */
+static int emit(const CNET *c, const char *name)
+{
+	FILE *fp = fopen(name, "w");
+	int l, i;
+
+	if(fp == NULL) return 0;
+	fprintf(fp, "#include <stdint.h>\n");
+	fprintf(fp, "typedef uint64_t v4w __attribute__((vector_size(32)));\n");
+	fprintf(fp, "typedef uint64_t v8w __attribute__((vector_size(64)));\n");
+	for(l = 0; l < 3; l++){
+		fprintf(fp, "\nvoid ccsim%d(uint64_t *w)\n{\n", cclanes[l]);
+		fprintf(fp, "\t%s *v = (%s *) w;\n", cctype[l], cctype[l]);
+		for(i = c->levoff[1]; i < c->n; i++)
+			if(c->fioff[i + 1] > c->fioff[i]) gate(fp, c, i);
+		fprintf(fp, "}\n");
+	}
+	return fclose(fp) == 0;
+}
+
+/* load the object name into c, 0 if it is missing or incomplete */
+static int load(CNET *c, const char *name)
+{
+	void *dl = dlopen(name, RTLD_NOW | RTLD_LOCAL), *fn[3];
+	char sym[16];
+	int l;
+
+	if(dl == NULL) return 0;
+	for(l = 0; l < 3; l++){
+		sprintf(sym, "ccsim%d", cclanes[l]);
+		if((fn[l] = dlsym(dl, sym)) == NULL){
+			dlclose(dl);
+			return 0;
+		}
+	}
+	ccsim_unload(c);
+	for(l = 0; l < 3; l++) *(void **) &c->csim[cclanes[l]] = fn[l];
+	c->dl = dl;
+	return 1;
+}
+
+/*-----------------------------------------------------------------------
+input: netlist, compiler command ("cc" if empty)
+output: 2 if the cached object was loaded, 1 if it was built and
+  loaded, 0 if the interpreted simulation stays in use
+called by: ccompile
+description: objects are cached as ccsim-<hash>.so in the private
+  directory of cachedir. The source is written next to it, compiled to
+  a temporary name and renamed, so a broken build never leaves an
+  object behind that a later COMPILE would load. Without a private
+  directory the object is built in a fresh mkdtemp directory, loaded
+  and removed again, and nothing is cached.
+author: Li
+-----------------------------------------------------------------------*/
+int ccsim(CNET *c, const char *cc)
+{
+	char dir[4096], so[4200], src[4200], tmp[4220], *cmd;
+	uint64_t h;
+	int r, keep;
+
+	if(*cc == '\0') cc = "cc";
+	h = ccsim_hash(c, cc);
+	if((keep = cachedir(dir, sizeof(dir))) == 0){
+		strcpy(dir, "/tmp/ccsim-XXXXXX");
+		if(mkdtemp(dir) == NULL) return 0;
+	}
+	sprintf(so, "%s/ccsim-%016llx.so", dir, (unsigned long long) h);
+	if(keep && owned(so) && load(c, so)) return 2;
+	sprintf(src, "%s/ccsim-%016llx.c", dir, (unsigned long long) h);
+	sprintf(tmp, "%s.%d", so, (int) getpid());
+	r = -1;
+	if(emit(c, src)){
+		cmd = (char *) malloc(strlen(cc) + sizeof(CCFLAGS) + strlen(tmp) + strlen(src) + 16);
+		sprintf(cmd, "%s %s -o '%s' '%s'", cc, CCFLAGS, tmp, src);
+		r = system(cmd);
+		free(cmd);
+		remove(src);
+	}
+	if(r != 0 || rename(tmp, so) != 0){
+		remove(tmp);
+		if(!keep) rmdir(dir);
+		return 0;
+	}
+	r = load(c, so);
+	if(!keep){
+		remove(so);
+		rmdir(dir);
+	}
+	return r;
+}
+
+/* back to the interpreted simulators */
+void ccsim_unload(CNET *c)
+{
+	if(c->dl) dlclose(c->dl);
+	c->dl = NULL;
+	memset(c->csim, 0, sizeof(c->csim));
+}
@@ -0,0 +1,26 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+/*-----------------------------------------------------------------------
+  compiled code simulation
+
+  The bit-parallel simulation of one netlist is written out as C, one
+  statement per gate in compiled (level) order with the node indices as
+  constants, built into a shared object by the system compiler and
+  loaded with dlopen. cnet_wsim then calls the generated code for 1, 4
+  and 8 lanes instead of walking the CSR columns. The object is built
+  with -march=native for this machine and named by a hash of the
+  netlist structure, the compiler and the CPU. It is cached in a
+  directory only this user can write ($XDG_CACHE_HOME/readckt or
+  ~/.cache/readckt), so each circuit is compiled once, and it is only
+  ever loaded by an explicit COMPILE. If no compiler is found or the
+  build fails the interpreted simulators of netlist.c stay in use.
+-----------------------------------------------------------------------*/
+#define CCSIM_VERSION 2
+
+/*----------------- new function        ----------------------------------*/
+extern uint64_t ccsim_hash(const CNET *c, const char *cc);
+extern int ccsim(CNET *c, const char *cc);
+extern void ccsim_unload(CNET *c);
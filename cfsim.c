@@ -0,0 +1,229 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "type.h"
+#include "netlist.h"
+#include "evsim.h"
+#include "pstore.h"
+#include "cfsim.h"
+
+#define SLAB (1 << 16)          /* ints per pool slab */
+
+/* block of 2^k ints, k >= 1 so a free block can hold the link pointer */
+static int *pget(struct cpool *p, int k)
+{
+	int *b = p->free[k];
+	if(b){
+		p->free[k] = *(int **) b;
+		return b;
+	}
+	if((1 << k) > SLAB) return (int *) malloc((1 << k) * sizeof(int));
+	if(p->left < (1 << k)){
+		p->slab = (int *) malloc(SLAB * sizeof(int));
+		p->slabs = (int **) realloc(p->slabs, (p->nslab + 1) * sizeof(int *));
+		p->slabs[p->nslab++] = p->slab;
+		p->left = SLAB;
+	}
+	b = p->slab;
+	p->slab += 1 << k;
+	p->left -= 1 << k;
+	return b;
+}
+
+static void pput(struct cpool *p, int *b, int k)
+{
+	*(int **) b = p->free[k];
+	p->free[k] = b;
+}
+
+static void pfree(struct cpool *p)
+{
+	int i, k;
+	int *b, *nx;
+	for(k = 0; k < 32; k++)      /* blocks larger than a slab were malloced */
+		if((1 << k) > SLAB)
+			for(b = p->free[k]; b; b = nx){
+				nx = *(int **) b;
+				free(b);
+			}
+	for(i = 0; i < p->nslab; i++) free(p->slabs[i]);
+	free(p->slabs);
+}
+
+/* replace the element list of node i by the n ids in l */
+static void setlist(struct cfsim *s, int i, const int *l, int n)
+{
+	int k = 1;
+	while((1 << k) < n) k++;
+	if(n == 0) k = 0;
+	if(k != s->ecls[i]){
+		if(s->ecls[i]) pput(&s->pool, s->el[i], s->ecls[i]);
+		s->el[i] = k ? pget(&s->pool, k) : NULL;
+		s->ecls[i] = k;
+	}
+	memcpy(s->el[i], l, n * sizeof(int));
+	s->elen[i] = n;
+}
+
+/* value of a gate of type t over the fan-in values v[0..n-1] */
+static int geval(int t, const unsigned char *v, int n)
+{
+	int i, x = v[0];
+	switch(t){
+		case NOT: return !x;
+		case XOR: for(i = 1; i < n; i++) x ^= v[i]; return x;
+		case OR: for(i = 1; i < n; i++) x |= v[i]; return x;
+		case NOR: for(i = 1; i < n; i++) x |= v[i]; return !x;
+		case AND: for(i = 1; i < n; i++) x &= v[i]; return x;
+		case NAND: for(i = 1; i < n; i++) x &= v[i]; return !x;
+	}
+	return x;
+}
+
+/*-----------------------------------------------------------------------
+input: state, node
+output: 1 if the good value or the element list of the node changed
+called by: cfsim
+description: merge the sorted element lists of the fan-ins. For every
+  machine found on some fan-in, the gate is evaluated with those fan-ins
+  flipped and the machine is kept only if the output still diverges.
+  The local fault of the node is added in its place in the order.
+author: Li
+-----------------------------------------------------------------------*/
+static int cfeval(struct cfsim *s, int i)
+{
+	const CNET *c = s->c;
+	const int *fi = c->fi + c->fioff[i];
+	int nf = c->fioff[i + 1] - c->fioff[i];
+	int *pos = s->pos;
+	unsigned char *gv = s->gv, *fv = s->fv;
+	int k, f, m, n = 0, need = 2, lf, g;
+
+	for(k = 0; k < nf; k++){
+		gv[k] = s->good[fi[k]];
+		pos[k] = 0;
+		need += s->elen[fi[k]];
+	}
+	if(need > s->bufcap){
+		s->bufcap = 2 * need;
+		s->buf = (int *) realloc(s->buf, s->bufcap * sizeof(int));
+	}
+	g = c->type[i] == IPT ? s->good[i] : geval(c->type[i], gv, nf);
+	lf = 2 * i + !g;                /* the local fault that shows here */
+	if(s->drop[lf]) lf = -1;
+	for(;;){
+		for(f = -1, k = 0; k < nf; k++)
+			if(pos[k] < s->elen[fi[k]]){
+				m = s->el[fi[k]][pos[k]];
+				if(f < 0 || m < f) f = m;
+			}
+		if(lf >= 0 && (f < 0 || lf < f)){
+			s->buf[n++] = lf;
+			lf = -1;
+			continue;
+		}
+		if(f < 0) break;
+		for(k = 0; k < nf; k++){
+			fv[k] = gv[k];
+			if(pos[k] < s->elen[fi[k]] && s->el[fi[k]][pos[k]] == f){
+				fv[k] ^= 1;
+				pos[k]++;
+			}
+		}
+		if(s->drop[f]) continue;
+		if(geval(c->type[i], fv, nf) != g) s->buf[n++] = f;
+	}
+	if(g == s->good[i] && n == s->elen[i]
+		&& (n == 0 || memcmp(s->buf, s->el[i], n * sizeof(int)) == 0))
+		return 0;
+	s->good[i] = g;
+	setlist(s, i, s->buf, n);
+	return 1;
+}
+
+/*-----------------------------------------------------------------------
+input: netlist, pattern store, 1 to check each vector against its target
+output: number of FArr faults detected; detvec[f] is the first vector
+  detecting fault f or -1, right[v] is 1 if vector v detects its target
+called by: CFS_client
+description: concurrent fault simulation of the vector sequence over all
+  faults of FArr. Detected faults are dropped, except that a fault is
+  kept while a later vector still targets it, so right[] is exact.
+author: Li
+-----------------------------------------------------------------------*/
+int cfsim(const CNET *c, const struct pstore *ps, int usetgt, int *right, int *detvec)
+{
+	struct cfsim s;
+	const int *tgt = usetgt ? ps->tgt : NULL;
+	const uint64_t *pv;
+	int i, k, v, f, n, nd = 0, nvec = ps->n, mfi = 1;
+
+	memset(&s, 0, sizeof(s));
+	s.c = c;
+	s.good = (unsigned char *) calloc(c->n, 1);
+	s.el = (int **) calloc(c->n, sizeof(int *));
+	s.elen = (int *) calloc(c->n, sizeof(int));
+	s.ecls = (unsigned char *) calloc(c->n, 1);
+	s.drop = (unsigned char *) calloc(2 * c->n, 1);
+	s.tref = (int *) calloc(2 * c->n, sizeof(int));
+	for(i = 0; i < c->n; i++)
+		if(c->fioff[i + 1] - c->fioff[i] > mfi) mfi = c->fioff[i + 1] - c->fioff[i];
+	s.pos = (int *) malloc(mfi * sizeof(int));
+	s.gv = (unsigned char *) malloc(mfi);
+	s.fv = (unsigned char *) malloc(mfi);
+	evq_init(&s.q, c);
+	for(f = 0; f < 2 * c->n; f++) detvec[f] = -1;
+	for(v = 0; tgt && v < nvec; v++) s.tref[tgt[v]]++;
+	/* settle the all 0 state, every node once */
+	for(i = 0; i < c->n; i++) cfeval(&s, i);
+
+	for(v = 0; v < nvec; v++){
+		pv = PS_VAL(ps, v);
+		for(k = 0; k < c->npi; k++){
+			i = c->pi[k];
+			if(s.good[i] != PS_BIT(pv, k)){
+				s.good[i] = PS_BIT(pv, k);
+				cfeval(&s, i);
+				evq_fanout(&s.q, i);
+			}
+		}
+		while((i = evq_pop(&s.q)) >= 0)
+			if(cfeval(&s, i)) evq_fanout(&s.q, i);
+		if(tgt){
+			right[v] = 0;
+			s.tref[tgt[v]]--;
+		}
+		for(k = 0; k < c->npo; k++){
+			i = c->po[k];
+			for(n = 0; n < s.elen[i]; n++){
+				f = s.el[i][n];
+				if(tgt && f == tgt[v]) right[v] = 1;
+				if(detvec[f] < 0){
+					detvec[f] = v;
+					nd++;
+				}
+				if(s.tref[f] == 0) s.drop[f] = 1;
+			}
+		}
+	}
+	evq_free(&s.q);
+	pfree(&s.pool);
+	for(i = 0; i < c->n; i++)      /* lists bigger than a slab */
+		if(s.ecls[i] && (1 << s.ecls[i]) > SLAB) free(s.el[i]);
+	free(s.good);
+	free(s.el);
+	free(s.elen);
+	free(s.ecls);
+	free(s.drop);
+	free(s.tref);
+	free(s.buf);
+	free(s.pos);
+	free(s.gv);
+	free(s.fv);
+	return nd;
+}
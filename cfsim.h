@@ -0,0 +1,40 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+/*-----------------------------------------------------------------------
+  concurrent fault simulation
+
+  Every node keeps the faulty machines whose value differs from the good
+  machine at that node, as a sorted array of fault ids. In two valued
+  logic a diverging machine always carries the complement of the good
+  value, so the id is the whole element. The arrays come from a pool of
+  power of two blocks. Between vectors only gates with a changed good
+  value or element list on a fan-in are evaluated again; machines that
+  converge at a gate are simply not copied into its new list.
+-----------------------------------------------------------------------*/
+struct cpool {
+	int *free[32];          /* free blocks per size class (2^k ints) */
+	int *slab, left;        /* current slab and ints left in it */
+	int **slabs, nslab;     /* every slab, freed at the end */
+};
+
+struct cfsim {
+	const CNET *c;
+	unsigned char *good;    /* good machine */
+	int **el;               /* element list of each node */
+	int *elen;              /* its length */
+	unsigned char *ecls;    /* its pool size class, 0 for no block */
+	unsigned char *drop;    /* fault is dropped */
+	int *tref;              /* vectors still to come that target the fault */
+	int *buf;               /* scratch list */
+	int bufcap;
+	int *pos;               /* per fan-in scratch, max fan-in long */
+	unsigned char *gv, *fv;
+	struct cpool pool;
+	struct evq q;
+};
+
+/*----------------- new function        ----------------------------------*/
+extern int cfsim(const CNET *c, const struct pstore *ps, int usetgt, int *right, int *detvec);
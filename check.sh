@@ -0,0 +1,42 @@
+#!/bin/sh
+# Author: zhenyu LI
+# group 7
+#
+# coverage parity, run by "make check": for each circuit PODEM makes the
+# vectors, then DFS, PFS, PPSFP and CFS grade them with 1 and 4 threads,
+# once on the instruction tape and once walking the netlist (TAPE off).
+# Every grader must report the same "Faults detected" line in every
+# run, and LOGIC must write the same output on both paths.
+# usage: check.sh [circuit ...]
+
+CKT=${*:-"c17.ckt c880.ckt c1355.ckt"}
+RC=./readckt
+fail=0
+
+run()   # tape circuit
+{
+	printf 'TAPE %s\nREAD %s\nPODEM -b 1000\nDFS\nPFS\nPPSFP\nCFS\nTHREADS 4\nDFS\nPFS\nPPSFP\nLOGIC 64 -n 4096 -o check-%s-64.txt\nLOGIC 512 -n 4096 -g -o check-%s-512.txt\nquit\n' \
+		"$1" "$2" "$1" "$1" | timeout 600 $RC | tr '>' '\n' | grep 'Faults detected'
+}
+
+for c in $CKT; do
+	on=$(run on "$c")
+	off=$(run off "$c")
+	n=$(printf '%s\n%s\n' "$on" "$off" | grep -c 'Faults detected')
+	u=$(printf '%s\n%s\n' "$on" "$off" | sort -u | grep -c 'Faults detected')
+	if [ "$n" -ne 14 ] || [ "$u" -ne 1 ]; then
+		echo "FAIL $c: graders disagree"
+		printf '%s\n%s\n' "$on" "$off" | sort | uniq -c
+		fail=1
+	else
+		echo "ok   $c: $(printf '%s\n' "$on" | head -n 1)"
+	fi
+	for w in 64 512; do
+		if ! cmp -s check-on-$w.txt check-off-$w.txt; then
+			echo "FAIL $c: LOGIC $w differs between TAPE on and off"
+			fail=1
+		fi
+	done
+	rm -f check-on-*.txt check-off-*.txt
+done
+exit $fail
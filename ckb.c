@@ -0,0 +1,189 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "type.h"
+#include "netlist.h"
+#include "ckb.h"
+
+/* sections of the image, each one starts 8 byte aligned */
+enum e_sec {S_TYPE, S_LEVEL, S_NUM, S_FIOFF, S_FI, S_FOOFF, S_FO, S_PI, S_PO,
+	S_LEVOFF, S_ORD, S_FC, S_LNOFF, S_LRN, S_CC0, S_CC1, S_CO, NSEC};
+
+struct ckb_head {
+	char magic[4];          /* "CKB" */
+	int version;            /* CKB_VERSION */
+	long long srcsize;      /* size of the .ckt file */
+	long long srcsec;       /* mtime of the .ckt file */
+	long long srcnsec;
+	int n, nfi, npi, npo, nlev, nbr, nfc, nlrn;
+	long long off[NSEC];    /* section offsets from the start of the file */
+	long long len[NSEC];    /* section sizes in bytes */
+};
+
+/* c17.ckt -> c17.ckb */
+void ckb_name(const char *ckt, char *name, int len)
+{
+	int n = strlen(ckt);
+	if(n > 4 && strcmp(ckt + n - 4, ".ckt") == 0) n -= 4;
+	snprintf(name, len, "%.*s.ckb", n, ckt);
+}
+
+/* fill in the section sizes of an image with the counts of h */
+void ckb_lens(struct ckb_head *h)
+{
+	long long o;
+	int i;
+	h->len[S_TYPE] = h->n;
+	h->len[S_LEVEL] = h->len[S_NUM] = h->len[S_ORD] = h->n * 4LL;
+	h->len[S_CC0] = h->len[S_CC1] = h->len[S_CO] = h->n * 4LL;
+	h->len[S_FIOFF] = h->len[S_FOOFF] = (h->n + 1) * 4LL;
+	h->len[S_FI] = h->len[S_FO] = h->nfi * 4LL;
+	h->len[S_PI] = h->npi * 4LL;
+	h->len[S_PO] = h->npo * 4LL;
+	h->len[S_LEVOFF] = (h->nlev + 1) * 4LL;
+	h->len[S_FC] = h->nfc * 4LL;
+	h->len[S_LNOFF] = (2 * h->n + 1) * 4LL;
+	h->len[S_LRN] = h->nlrn * 4LL;
+	o = sizeof(struct ckb_head);
+	for(i = 0; i < NSEC; i++){
+		h->off[i] = o;
+		o += (h->len[i] + 7) & ~7LL;
+	}
+}
+
+/*-----------------------------------------------------------------------
+input: image name, stat of the source .ckt, circuit to store
+output: 1 if the image was written
+called by: cread
+description: write the image to name.tmp and rename it into place, so a
+  reader never sees a half written file.
+author: Li
+-----------------------------------------------------------------------*/
+int ckb_save(const char *name, const struct stat *src, const struct ckb *k)
+{
+	struct ckb_head h;
+	const CNET *c = k->c;
+	const void *sec[NSEC];
+	static const char zero[8];
+	char tmp[1024];
+	FILE *fp;
+	long long o;
+	int i, ok;
+
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, "CKB", 4);
+	h.version = CKB_VERSION;
+	h.srcsize = src->st_size;
+	h.srcsec = src->st_mtim.tv_sec;
+	h.srcnsec = src->st_mtim.tv_nsec;
+	h.n = c->n; h.nfi = c->nfi; h.npi = c->npi; h.npo = c->npo;
+	h.nlev = c->nlev; h.nbr = k->nbr; h.nfc = k->nfc; h.nlrn = c->nlrn;
+	ckb_lens(&h);
+	sec[S_TYPE] = c->type; sec[S_LEVEL] = c->level; sec[S_NUM] = c->num;
+	sec[S_FIOFF] = c->fioff; sec[S_FI] = c->fi; sec[S_FOOFF] = c->fooff;
+	sec[S_FO] = c->fo; sec[S_PI] = c->pi; sec[S_PO] = c->po;
+	sec[S_LEVOFF] = c->levoff; sec[S_ORD] = c->ord; sec[S_FC] = k->fc;
+	sec[S_LNOFF] = c->lnoff; sec[S_LRN] = c->lrn;
+	sec[S_CC0] = c->cc0; sec[S_CC1] = c->cc1; sec[S_CO] = c->co;
+
+	snprintf(tmp, sizeof(tmp), "%s.tmp", name);
+	if((fp = fopen(tmp, "wb")) == NULL) return 0;
+	ok = fwrite(&h, sizeof(h), 1, fp) == 1;
+	o = sizeof(h);
+	for(i = 0; i < NSEC && ok; i++){
+		if(h.len[i] && fwrite(sec[i], h.len[i], 1, fp) != 1) ok = 0;
+		o += h.len[i];
+		if(o & 7){
+			fwrite(zero, 8 - (o & 7), 1, fp);
+			o = (o + 7) & ~7LL;
+		}
+	}
+	if(fclose(fp) != 0) ok = 0;
+	if(!ok || rename(tmp, name) != 0){
+		unlink(tmp);
+		return 0;
+	}
+	return 1;
+}
+
+/*-----------------------------------------------------------------------
+input: image name, stat of the source .ckt
+output: 1 and k filled in if a current image was found, 0 otherwise
+called by: cread
+description: map the image and point the compiled netlist columns
+  straight into the mapping, nothing is copied. The mapping is released
+  by cnet_free. An image of another version, or stamped with another
+  size or mtime than the source file, is ignored.
+author: Li
+-----------------------------------------------------------------------*/
+int ckb_load(const char *name, const struct stat *src, struct ckb *k)
+{
+	struct ckb_head h, *hp;
+	struct stat st;
+	char *map;
+	CNET *c;
+	int fd, i;
+
+	if((fd = open(name, O_RDONLY)) < 0) return 0;
+	if(fstat(fd, &st) != 0 || st.st_size < (off_t) sizeof(h)){
+		close(fd);
+		return 0;
+	}
+	map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(map == MAP_FAILED) return 0;
+	hp = (struct ckb_head *) map;
+	if(memcmp(hp->magic, "CKB", 4) || hp->version != CKB_VERSION
+		|| hp->srcsize != src->st_size || hp->srcsec != src->st_mtim.tv_sec
+		|| hp->srcnsec != src->st_mtim.tv_nsec) {
+		munmap(map, st.st_size);
+		return 0;
+	}
+	/* recompute the layout rather than trust the offsets in the file */
+	memset(&h, 0, sizeof(h));
+	h.n = hp->n; h.nfi = hp->nfi; h.npi = hp->npi; h.npo = hp->npo;
+	h.nlev = hp->nlev; h.nfc = hp->nfc; h.nlrn = hp->nlrn;
+	ckb_lens(&h);
+	for(i = 0; i < NSEC; i++)
+		if(h.off[i] != hp->off[i] || h.off[i] + h.len[i] > st.st_size){
+			munmap(map, st.st_size);
+			return 0;
+		}
+
+	c = (CNET *) calloc(1, sizeof(CNET));
+	c->n = h.n; c->nfi = h.nfi; c->npi = h.npi; c->npo = h.npo; c->nlev = h.nlev;
+	c->type = (unsigned char *)(map + h.off[S_TYPE]);
+	c->level = (int *)(map + h.off[S_LEVEL]);
+	c->num = (int *)(map + h.off[S_NUM]);
+	c->fioff = (int *)(map + h.off[S_FIOFF]);
+	c->fi = (int *)(map + h.off[S_FI]);
+	c->fooff = (int *)(map + h.off[S_FOOFF]);
+	c->fo = (int *)(map + h.off[S_FO]);
+	c->pi = (int *)(map + h.off[S_PI]);
+	c->po = (int *)(map + h.off[S_PO]);
+	c->levoff = (int *)(map + h.off[S_LEVOFF]);
+	c->ord = (int *)(map + h.off[S_ORD]);
+	c->lnoff = (int *)(map + h.off[S_LNOFF]);
+	c->lrn = (int *)(map + h.off[S_LRN]);
+	c->nlrn = h.nlrn;
+	c->cc0 = (int *)(map + h.off[S_CC0]);
+	c->cc1 = (int *)(map + h.off[S_CC1]);
+	c->co = (int *)(map + h.off[S_CO]);
+	c->val = (unsigned char *) calloc(c->n, sizeof(unsigned char));
+	c->map = map;
+	c->maplen = st.st_size;
+	k->c = c;
+	k->nbr = hp->nbr;
+	k->nfc = h.nfc;
+	k->fc = (int *)(map + h.off[S_FC]);
+	return 1;
+}
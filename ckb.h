@@ -0,0 +1,31 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+#include <sys/stat.h>
+
+/*-----------------------------------------------------------------------
+  precompiled circuit image (.ckb)
+
+  A .ckb file holds everything READ derives from a .ckt file: the
+  compiled netlist columns, the PI/PO lists, the branch count and the
+  collapsed fault list as FArr indices, the learned implications and
+  the SCOAP measures. The original fault list is not stored since fault
+  k of FArr is always stuck-at k%2 on compiled node k/2. The image is
+  stamped with the size and mtime of the source file and is only used
+  while they still match.
+-----------------------------------------------------------------------*/
+#define CKB_VERSION 4
+
+struct ckb {
+	CNET *c;        /* compiled netlist */
+	int nbr;        /* number of branches */
+	int nfc;        /* number of collapsed faults */
+	int *fc;        /* collapsed fault list, FArr indices */
+};
+
+/*----------------- new function        ----------------------------------*/
+extern void ckb_name(const char *ckt, char *name, int len);
+extern int ckb_load(const char *name, const struct stat *src, struct ckb *k);
+extern int ckb_save(const char *name, const struct stat *src, const struct ckb *k);
@@ -0,0 +1,449 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "type.h"
+#include "netlist.h"
+#include "evsim.h"
+#include "atpg.h"
+#include "dalg.h"
+
+#define X 2
+#define ERR(d, i) ((d)->v[0][i] != X && (d)->v[1][i] != X && (d)->v[0][i] != (d)->v[1][i])
+#define OPEN(d, i) ((d)->v[0][i] == X || (d)->v[1][i] == X)
+
+void dalg_init(struct dalg *d, const CNET *c, long maxbt, double maxsec)
+{
+	int i;
+	memset(d, 0, sizeof(*d));
+	d->c = c;
+	d->v[0] = (unsigned char *) malloc(c->n);
+	d->v[1] = (unsigned char *) malloc(c->n);
+	d->incone = (unsigned char *) malloc(c->n);
+	d->jf = (int *) malloc((2 * c->n + 1) * sizeof(int));
+	d->jpos = (int *) malloc(2 * c->n * sizeof(int));
+	d->df = (int *) malloc((c->n + 1) * sizeof(int));
+	d->dpos = (int *) malloc(c->n * sizeof(int));
+	d->ispo = (unsigned char *) calloc(c->n, 1);
+	for(i = 0; i < c->npo; i++) d->ispo[c->po[i]] = 1;
+	d->q = (int *) malloc((c->n + 1) * sizeof(int));
+	d->inq = (unsigned char *) calloc(c->n, 1);
+	d->stamp = (int *) calloc(c->n, sizeof(int));
+	d->maxbt = maxbt;
+	d->maxsec = maxsec;
+}
+
+void dalg_free(struct dalg *d)
+{
+	free(d->v[0]);
+	free(d->v[1]);
+	free(d->incone);
+	free(d->tcode);
+	free(d->tval);
+	free(d->jf);
+	free(d->jpos);
+	free(d->df);
+	free(d->dpos);
+	free(d->ispo);
+	free(d->q);
+	free(d->inq);
+	free(d->stamp);
+	free(d->st);
+	free(d->alts);
+}
+
+/* 3-valued value of gate i over half h of its fan-ins */
+static int fwd(const struct dalg *d, int i, int h)
+{
+	const CNET *c = d->c;
+	const unsigned char *v = d->v[h];
+	int k, x, y, t = c->type[i], any = 0;
+
+	k = c->fioff[i];
+	switch(t){
+		case BRCH:
+		case NOT:
+			x = v[c->fi[k]];
+			return t == NOT && x != X ? !x : x;
+		case XOR:
+			for(y = 0; k < c->fioff[i + 1]; k++){
+				if((x = v[c->fi[k]]) == X) return X;
+				y ^= x;
+			}
+			return y;
+		case AND:
+		case NAND:
+			for(; k < c->fioff[i + 1]; k++){
+				if((x = v[c->fi[k]]) == 0) return t == NAND;
+				any |= x == X;
+			}
+			return any ? X : t == AND;
+		case OR:
+		case NOR:
+			for(; k < c->fioff[i + 1]; k++){
+				if((x = v[c->fi[k]]) == 1) return t == OR;
+				any |= x == X;
+			}
+			return any ? X : t == NOR;
+	}
+	return X;
+}
+
+/* half h of node i is set from its fan-ins (not a PI, not the faulty site) */
+static int driven(const struct dalg *d, int i, int h)
+{
+	return d->c->type[i] != IPT && !(i == d->fnode && h == 1);
+}
+
+static void jset(struct dalg *d, int code, int in)
+{
+	int k;
+	if(in && d->jpos[code] < 0){
+		d->jpos[code] = d->njf;
+		d->jf[d->njf++] = code;
+	}
+	else if(!in && d->jpos[code] >= 0){
+		k = d->jf[--d->njf];
+		d->jf[d->jpos[code]] = k;
+		d->jpos[k] = d->jpos[code];
+		d->jpos[code] = -1;
+	}
+}
+
+/* recompute the J- and D-frontier membership of node i */
+static void member(struct dalg *d, int i)
+{
+	const CNET *c = d->c;
+	int h, k, in = 0;
+
+	for(h = 0; h < 2; h++)
+		jset(d, 2 * i + h, driven(d, i, h) && d->v[h][i] != X && fwd(d, i, h) == X);
+	if(c->type[i] != IPT && OPEN(d, i))
+		for(k = c->fioff[i]; k < c->fioff[i + 1] && !in; k++) in = ERR(d, c->fi[k]);
+	if(in && d->dpos[i] < 0){
+		d->dpos[i] = d->ndf;
+		d->df[d->ndf++] = i;
+	}
+	else if(!in && d->dpos[i] >= 0){
+		k = d->df[--d->ndf];
+		d->df[d->dpos[i]] = k;
+		d->dpos[k] = d->dpos[i];
+		d->dpos[i] = -1;
+	}
+}
+
+static void around(struct dalg *d, int i)
+{
+	const CNET *c = d->c;
+	int k;
+	member(d, i);
+	for(k = c->fooff[i]; k < c->fooff[i + 1]; k++) member(d, c->fo[k]);
+}
+
+static void enq(struct dalg *d, int i)
+{
+	if(d->inq[i]) return;
+	d->inq[i] = 1;
+	d->q[d->nq++] = i;
+}
+
+/* raw change of half h of node i, trailed */
+static void change(struct dalg *d, int i, int h, int x)
+{
+	const CNET *c = d->c;
+	int k, e = ERR(d, i);
+
+	if(d->ntrail == d->tcap){
+		d->tcap = d->tcap ? 2 * d->tcap : 1024;
+		d->tcode = (int *) realloc(d->tcode, d->tcap * sizeof(int));
+		d->tval = (unsigned char *) realloc(d->tval, d->tcap);
+	}
+	d->tcode[d->ntrail] = 2 * i + h;
+	d->tval[d->ntrail++] = d->v[h][i];
+	d->v[h][i] = x;
+	if(d->ispo[i]) d->ndpo += ERR(d, i) - e;
+	around(d, i);
+	enq(d, i);
+	for(k = c->fooff[i]; k < c->fooff[i + 1]; k++) enq(d, c->fo[k]);
+	for(k = c->fioff[i]; k < c->fioff[i + 1]; k++) enq(d, c->fi[k]);
+}
+
+/* assign half h of node i, 0 on a conflict */
+static int seth(struct dalg *d, int i, int h, int x)
+{
+	if(d->v[h][i] == x) return 1;
+	if(d->v[h][i] != X) return 0;
+	change(d, i, h, x);
+	if(!d->incone[i] && d->v[!h][i] != x){
+		if(d->v[!h][i] != X) return 0;
+		change(d, i, !h, x);
+	}
+	return 1;
+}
+
+/*-----------------------------------------------------------------------
+input: state, node
+output: 0 on a conflict
+called by: imply
+description: forward and backward implication of both halves of gate i
+  through the singular cover of its type. Backward implication only
+  fires when a single input choice is left; otherwise the half stays
+  in the J-frontier.
+author: Li
+-----------------------------------------------------------------------*/
+static int examine(struct dalg *d, int i)
+{
+	const CNET *c = d->c;
+	const int *fi = c->fi + c->fioff[i];
+	int nf = c->fioff[i + 1] - c->fioff[i];
+	int h, k, t = c->type[i], x, out, cv, core, nx, last, par;
+
+	for(h = 0; h < 2; h++){
+		if(!driven(d, i, h)) continue;
+		x = fwd(d, i, h);
+		out = d->v[h][i];
+		if(x != X){
+			if(!seth(d, i, h, x)) return 0;
+			continue;
+		}
+		if(out == X) continue;
+		switch(t){
+			case BRCH:
+			case NOT:
+				if(!seth(d, fi[0], h, out ^ (t == NOT))) return 0;
+				break;
+			case XOR:
+				for(nx = par = 0, last = -1, k = 0; k < nf; k++)
+					if(d->v[h][fi[k]] == X){
+						nx++;
+						last = fi[k];
+					}
+					else par ^= d->v[h][fi[k]];
+				if(nx == 1 && !seth(d, last, h, out ^ par)) return 0;
+				break;
+			default:
+				cv = t == AND || t == NAND ? 0 : 1;
+				core = out ^ (t == NAND || t == NOR);
+				if(core != cv){         /* every input non-controlling */
+					for(k = 0; k < nf; k++)
+						if(!seth(d, fi[k], h, !cv)) return 0;
+					break;
+				}
+				for(nx = 0, last = -1, k = 0; k < nf; k++)
+					if(d->v[h][fi[k]] == X){
+						nx++;
+						last = fi[k];
+					}
+				if(nx == 1 && !seth(d, last, h, cv)) return 0;
+		}
+	}
+	return 1;
+}
+
+static int imply(struct dalg *d)
+{
+	int i;
+	while(d->nq){
+		i = d->q[--d->nq];
+		d->inq[i] = 0;
+		if(!examine(d, i)){
+			while(d->nq) d->inq[d->q[--d->nq]] = 0;
+			return 0;
+		}
+	}
+	return 1;
+}
+
+static void undo(struct dalg *d, int mark)
+{
+	int i, h, e;
+	while(d->ntrail > mark){
+		d->ntrail--;
+		i = d->tcode[d->ntrail] >> 1;
+		h = d->tcode[d->ntrail] & 1;
+		e = ERR(d, i);
+		d->v[h][i] = d->tval[d->ntrail];
+		if(d->ispo[i]) d->ndpo += ERR(d, i) - e;
+		around(d, i);
+	}
+}
+
+/* 1 if a path of open nodes leads from gate g to a PO */
+static int xpath(struct dalg *d, int g)
+{
+	const CNET *c = d->c;
+	int k;
+	if(d->ispo[g]) return 1;
+	if(d->stamp[g] == d->epoch) return 0;
+	d->stamp[g] = d->epoch;
+	for(k = c->fooff[g]; k < c->fooff[g + 1]; k++)
+		if(OPEN(d, c->fo[k]) && xpath(d, c->fo[k])) return 1;
+	return 0;
+}
+
+static void addalt(struct dalg *d, int x)
+{
+	if(d->nalts == d->acap){
+		d->acap = d->acap ? 2 * d->acap : 1024;
+		d->alts = (int *) realloc(d->alts, d->acap * sizeof(int));
+	}
+	d->alts[d->nalts++] = x;
+}
+
+/* push a decision with its alternatives, 0 if it has none */
+static int decide(struct dalg *d)
+{
+	const CNET *c = d->c;
+	struct dframe *fr;
+	int k, g, h, j, t, cv, aoff = d->nalts;
+
+	if(d->nst == d->stcap){
+		d->stcap = d->stcap ? 2 * d->stcap : 256;
+		d->st = (struct dframe *) realloc(d->st, d->stcap * sizeof(struct dframe));
+	}
+	fr = &d->st[d->nst];
+	if(d->ndpo){
+		/* justify a J-frontier half, alternatives are 2*input+value */
+		fr->kind = 1;
+		g = fr->g = d->jf[0] >> 1;
+		h = fr->h = d->jf[0] & 1;
+		t = c->type[g];
+		cv = t == AND || t == NAND ? 0 : 1;
+		for(k = c->fioff[g]; k < c->fioff[g + 1]; k++){
+			j = c->fi[k];
+			if(d->v[h][j] != X) continue;
+			if(t == XOR){
+				addalt(d, 2 * j);
+				addalt(d, 2 * j + 1);
+				break;
+			}
+			addalt(d, 2 * j + cv);
+		}
+	}
+	else{
+		/* propagate through a D-frontier gate that has an X path,
+		   alternatives are 2*gate+value; an XOR passes the fault
+		   effect for either value of a side input, so it gets both */
+		fr->kind = 0;
+		for(k = 0; k < d->ndf; k++){
+			d->epoch++;
+			if(!xpath(d, d->df[k])) continue;
+			addalt(d, 2 * d->df[k]);
+			if(c->type[d->df[k]] == XOR) addalt(d, 2 * d->df[k] + 1);
+		}
+	}
+	if(d->nalts == aoff) return 0;
+	fr->mark = d->ntrail;
+	fr->aoff = aoff;
+	fr->nalt = d->nalts - aoff;
+	fr->alt = -1;
+	d->nst++;
+	return 1;
+}
+
+/* apply one alternative of fr. Propagation sets the open side inputs
+   of the gate to the non-controlling value; for an XOR only the first
+   open side input is set, to the value of the alternative, and the
+   gate stays in the D-frontier until the others are decided too. */
+static int apply(struct dalg *d, struct dframe *fr, int x)
+{
+	const CNET *c = d->c;
+	int k, j, h, g = x >> 1, t, nc;
+
+	if(fr->kind) return seth(d, g, fr->h, x & 1);
+	t = c->type[g];
+	nc = t == XOR ? x & 1 : t == AND || t == NAND;
+	for(k = c->fioff[g]; k < c->fioff[g + 1]; k++){
+		j = c->fi[k];
+		if(ERR(d, j) || !OPEN(d, j)) continue;
+		for(h = 0; h < 2; h++)
+			if(d->v[h][j] == X && !seth(d, j, h, nc)) return 0;
+		if(t == XOR) break;
+	}
+	return 1;
+}
+
+/* try the alternatives of the top decision after the current one */
+static int next(struct dalg *d)
+{
+	struct dframe *fr = &d->st[d->nst - 1];
+	while(++fr->alt < fr->nalt){
+		undo(d, fr->mark);
+		if(apply(d, fr, d->alts[fr->aoff + fr->alt]) && imply(d)) return 1;
+		while(d->nq) d->inq[d->q[--d->nq]] = 0;
+	}
+	undo(d, fr->mark);
+	return 0;
+}
+
+static void pop(struct dalg *d)
+{
+	d->nst--;
+	d->nalts = d->st[d->nst].aoff;
+}
+
+/* mark the fan-out cone of node i */
+static void cone(struct dalg *d, int i)
+{
+	const CNET *c = d->c;
+	int k;
+	if(d->incone[i]) return;
+	d->incone[i] = 1;
+	for(k = c->fooff[i]; k < c->fooff[i + 1]; k++) cone(d, c->fo[k]);
+}
+
+/*-----------------------------------------------------------------------
+input: state, FArr fault id, room for a vector of npi values
+output: T_DETECTED with the test cube in vec (2 for X), T_REDUNDANT or
+  T_ABORTED
+called by: D_client
+description: D-algorithm for one fault. The primitive D-cube of the
+  fault is implied first, then the search alternates between driving
+  the fault effect through the D-frontier and justifying the J-frontier
+  once a PO shows it.
+author: Li
+-----------------------------------------------------------------------*/
+int dalg(struct dalg *d, int f, int *vec)
+{
+	const CNET *c = d->c;
+	struct timespec t0, t1;
+	int k;
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	memset(d->v[0], X, c->n);
+	memset(d->v[1], X, c->n);
+	memset(d->incone, 0, c->n);
+	memset(d->jpos, -1, 2 * c->n * sizeof(int));
+	memset(d->dpos, -1, c->n * sizeof(int));
+	d->njf = d->ndf = d->ndpo = d->ntrail = d->nst = d->nalts = 0;
+	d->bt = 0;
+	d->fnode = f / 2;
+	d->fval = f % 2;
+	cone(d, d->fnode);
+	if(!seth(d, d->fnode, 1, d->fval) || !seth(d, d->fnode, 0, !d->fval) || !imply(d))
+		return T_REDUNDANT;
+	for(;;){
+		if(d->ndpo && d->njf == 0){
+			for(k = 0; k < c->npi; k++) vec[k] = d->v[0][c->pi[k]];
+			return T_DETECTED;
+		}
+		if(decide(d)){
+			if(next(d)) continue;
+			pop(d);
+		}
+		for(;;){
+			if(d->nst == 0) return T_REDUNDANT;
+			clock_gettime(CLOCK_MONOTONIC, &t1);
+			if(++d->bt > d->maxbt || (d->maxsec > 0 && t1.tv_sec - t0.tv_sec
+				+ (t1.tv_nsec - t0.tv_nsec) * 1e-9 > d->maxsec))
+				return T_ABORTED;
+			if(next(d)) break;
+			pop(d);
+		}
+	}
+}
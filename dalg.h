@@ -0,0 +1,54 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+/*-----------------------------------------------------------------------
+  D-algorithm
+
+  Unlike PODEM any line can be assigned. Each node carries a good and a
+  faulty half, each 0, 1 or X, and the halves are implied forward and
+  backward through the singular cover of the gate type. Outside the
+  fan-out cone of the fault both halves are the same line and move
+  together. A half whose value is not yet implied by the gate inputs
+  sits in the J-frontier; a gate with a fault effect on an input and an
+  open output sits in the D-frontier. Both are indexed sets fixed up on
+  every change and on undo. Decisions (propagate through a D-frontier
+  gate, or justify a J-frontier half) keep their alternatives on a
+  stack and are undone through the trail.
+-----------------------------------------------------------------------*/
+struct dframe {
+	int mark;               /* trail length before the decision */
+	int alt, nalt;          /* alternative tried and how many there are */
+	int aoff;               /* alternatives start at alts[aoff] */
+	int kind;               /* 0 propagate, 1 justify */
+	int g, h;               /* justify: gate and half */
+};
+
+struct dalg {
+	const CNET *c;
+	unsigned char *v[2];    /* good [0] and faulty [1] halves, 2 for X */
+	unsigned char *incone;  /* node is in the fan-out cone of the fault */
+	int *tcode;             /* trail: 2*node+half */
+	unsigned char *tval;
+	int ntrail, tcap;
+	int *jf, *jpos, njf;    /* J-frontier over 2*node+half */
+	int *df, *dpos, ndf;    /* D-frontier over nodes */
+	int ndpo;               /* POs showing the fault */
+	unsigned char *ispo;
+	int *q, nq;             /* nodes to examine */
+	unsigned char *inq;
+	int *stamp, epoch;
+	int fnode, fval;
+	struct dframe *st;      /* decision stack */
+	int nst, stcap;
+	int *alts, nalts, acap;
+	long maxbt;
+	double maxsec;
+	long bt;
+};
+
+/*----------------- new function        ----------------------------------*/
+extern void dalg_init(struct dalg *d, const CNET *c, long maxbt, double maxsec);
+extern void dalg_free(struct dalg *d);
+extern int dalg(struct dalg *d, int f, int *vec);
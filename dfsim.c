@@ -0,0 +1,137 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "type.h"
+#include "netlist.h"
+#include "dfsim.h"
+
+#define SET(s, i) ((s)->arena + (size_t) (s)->slot[i] * (s)->nw)
+
+/*-----------------------------------------------------------------------
+input: state, netlist
+output: nothing
+called by: DFS_client
+description: size the arena. Nodes are evaluated in level order and a
+  node's set is released once its last fan-out has read it (a PO is
+  folded into the detected set right away), so replaying that order
+  with the fan-out counts gives the peak number of live sets.
+author: Li
+-----------------------------------------------------------------------*/
+void dfsim_init(struct dfsim *s, const CNET *c)
+{
+	int i, k, live = 0, peak = 0;
+
+	s->c = c;
+	s->nw = (2 * c->n + 63) / 64;
+	s->slot = (int *) malloc(c->n * sizeof(int));
+	s->ref = (int *) malloc(c->n * sizeof(int));
+	s->ispo = (unsigned char *) calloc(c->n, 1);
+	for(i = 0; i < c->npo; i++) s->ispo[c->po[i]] = 1;
+	for(i = 0; i < c->n; i++) s->ref[i] = c->fooff[i + 1] - c->fooff[i];
+	for(i = 0; i < c->n; i++){
+		if(++live > peak) peak = live;
+		for(k = c->fioff[i]; k < c->fioff[i + 1]; k++)
+			if(--s->ref[c->fi[k]] == 0) live--;
+		if(s->ref[i] == 0) live--;
+	}
+	s->nslot = peak;
+	s->arena = (uint64_t *) malloc((size_t) peak * s->nw * sizeof(uint64_t));
+	s->det = (uint64_t *) malloc(s->nw * sizeof(uint64_t));
+	s->tmp = (uint64_t *) malloc(s->nw * sizeof(uint64_t));
+	s->free = (int *) malloc(peak * sizeof(int));
+	s->drop = NULL;
+}
+
+void dfsim_free(struct dfsim *s)
+{
+	free(s->slot);
+	free(s->ref);
+	free(s->ispo);
+	free(s->arena);
+	free(s->det);
+	free(s->tmp);
+	free(s->free);
+}
+
+static void release(struct dfsim *s, int i)
+{
+	if(--s->ref[i] == 0) s->free[s->nfree++] = s->slot[i];
+}
+
+/*-----------------------------------------------------------------------
+input: state, fault free values of every node
+output: set of the faults the vector detects, valid until the next run
+called by: tsim
+description: one deductive pass in level order. With S the fan-ins at
+  the controlling value of the gate, the list of the output is the
+  union of all fan-in lists when S is empty, and otherwise the faults
+  in every list of S but in no list outside S. XOR passes the faults
+  that reach an odd number of its fan-ins. The local fault of the
+  opposite value is added last.
+author: Li
+-----------------------------------------------------------------------*/
+const uint64_t *dfsim_run(struct dfsim *s, const unsigned char *val)
+{
+	const CNET *c = s->c;
+	const int *fi;
+	int nw = s->nw;
+	int i, k, w, t, nf, cv, ncv, f;
+	uint64_t *o, *x, *u = s->tmp;
+
+	s->nfree = 0;
+	for(i = 0; i < s->nslot; i++) s->free[s->nfree++] = s->nslot - 1 - i;
+	for(i = 0; i < c->n; i++) s->ref[i] = c->fooff[i + 1] - c->fooff[i];
+	memset(s->det, 0, nw * sizeof(uint64_t));
+
+	for(i = 0; i < c->n; i++){
+		s->slot[i] = s->free[--s->nfree];
+		o = SET(s, i);
+		t = c->type[i];
+		fi = c->fi + c->fioff[i];
+		nf = c->fioff[i + 1] - c->fioff[i];
+		switch(t){
+			case IPT:
+				memset(o, 0, nw * sizeof(uint64_t));
+				break;
+			case BRCH:
+			case NOT:
+				memcpy(o, SET(s, fi[0]), nw * sizeof(uint64_t));
+				break;
+			case XOR:
+				memcpy(o, SET(s, fi[0]), nw * sizeof(uint64_t));
+				for(k = 1; k < nf; k++)
+					for(x = SET(s, fi[k]), w = 0; w < nw; w++) o[w] ^= x[w];
+				break;
+			default:
+				cv = t == AND || t == NAND ? 0 : 1;
+				for(ncv = 0, k = 0; k < nf; k++) ncv += val[fi[k]] == cv;
+				if(ncv == 0){
+					memset(o, 0, nw * sizeof(uint64_t));
+					for(k = 0; k < nf; k++)
+						for(x = SET(s, fi[k]), w = 0; w < nw; w++) o[w] |= x[w];
+					break;
+				}
+				/* o = intersection over S, u = union outside S */
+				for(w = 0; w < nw; w++) o[w] = ~0ULL;
+				memset(u, 0, nw * sizeof(uint64_t));
+				for(k = 0; k < nf; k++){
+					x = SET(s, fi[k]);
+					if(val[fi[k]] == cv) for(w = 0; w < nw; w++) o[w] &= x[w];
+					else for(w = 0; w < nw; w++) u[w] |= x[w];
+				}
+				for(w = 0; w < nw; w++) o[w] &= ~u[w];
+		}
+		f = 2 * i + !val[i];
+		if(!s->drop || !((s->drop[f >> 6] >> (f & 63)) & 1))
+			o[f >> 6] |= 1ULL << (f & 63);
+		if(s->ispo[i]) for(w = 0; w < nw; w++) s->det[w] |= o[w];
+		for(k = 0; k < nf; k++) release(s, fi[k]);
+		if(s->ref[i] == 0) s->free[s->nfree++] = s->slot[i];
+	}
+	return s->det;
+}
@@ -0,0 +1,35 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+/*-----------------------------------------------------------------------
+  deductive fault simulation over fault bitsets
+
+  The fault list of a node is a bitset over FArr ids, nw 64 bit words,
+  so the deductive rules become word wide set operations. Sets live in
+  slots of one arena allocated by dfsim_init; a slot is taken when its
+  node is evaluated and given back once the last fan-out has read it.
+  The peak number of live slots for the level order is found at init,
+  so dfsim_run does no allocation at all. Faults set in drop are never
+  inserted, so they stay out of every list.
+-----------------------------------------------------------------------*/
+struct dfsim {
+	const CNET *c;
+	int nw;                 /* words per fault set */
+	int nslot;              /* slots in the arena */
+	uint64_t *arena;        /* nslot sets of nw words */
+	uint64_t *det;          /* faults seen on some PO */
+	uint64_t *tmp;          /* scratch set */
+	int *slot;              /* slot of each live node */
+	int *ref;               /* fan-outs still to read the node */
+	unsigned char *ispo;    /* 1 for primary outputs */
+	int *free;              /* stack of free slots */
+	int nfree;
+	const uint64_t *drop;   /* faults left out of the run, or NULL */
+};
+
+/*----------------- new function        ----------------------------------*/
+extern void dfsim_init(struct dfsim *s, const CNET *c);
+extern void dfsim_free(struct dfsim *s);
+extern const uint64_t *dfsim_run(struct dfsim *s, const unsigned char *val);
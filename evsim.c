@@ -0,0 +1,147 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "type.h"
+#include "netlist.h"
+#include "evsim.h"
+
+void evq_init(struct evq *q, const CNET *c)
+{
+	int i;
+	q->c = c;
+	q->buf = (int *) malloc((c->n + 1) * sizeof(int));
+	q->cnt = (int *) calloc(c->nlev + 1, sizeof(int));
+	q->mark = (unsigned char *) calloc(c->n, 1);
+	q->touch = (int *) malloc(2 * (c->n + 1) * sizeof(int));  /* a node can be set, then re-evaluated */
+	q->ispo = (unsigned char *) calloc(c->n, 1);
+	for(i = 0; i < c->npo; i++) q->ispo[c->po[i]] = 1;
+	q->lo = c->nlev;
+	q->nq = q->ntouch = 0;
+}
+
+void evq_free(struct evq *q)
+{
+	free(q->buf);
+	free(q->cnt);
+	free(q->mark);
+	free(q->touch);
+	free(q->ispo);
+}
+
+/* queue node i unless it is queued already */
+void evq_push(struct evq *q, int i)
+{
+	int l;
+	if(q->mark[i]) return;
+	q->mark[i] = 1;
+	l = q->c->level[i];
+	q->buf[q->c->levoff[l] + q->cnt[l]++] = i;
+	if(l < q->lo) q->lo = l;
+	q->nq++;
+}
+
+/* next event in level order, -1 if there is none */
+int evq_pop(struct evq *q)
+{
+	int i;
+	if(q->nq == 0) return -1;
+	while(q->cnt[q->lo] == 0) q->lo++;
+	i = q->buf[q->c->levoff[q->lo] + --q->cnt[q->lo]];
+	q->mark[i] = 0;
+	q->nq--;
+	return i;
+}
+
+void evq_fanout(struct evq *q, int i)
+{
+	const CNET *c = q->c;
+	int k;
+	for(k = c->fooff[i]; k < c->fooff[i + 1]; k++)
+		evq_push(q, c->fo[k]);
+}
+
+/* drop all pending events */
+void evq_clear(struct evq *q)
+{
+	int i;
+	while((i = evq_pop(q)) >= 0);
+	q->lo = q->c->nlev;
+}
+
+/*-----------------------------------------------------------------------
+input: queue, 0/1 value column
+output: number of gates evaluated
+called by: tsim
+description: scalar selective trace, val must be consistent except for
+  the nodes whose fan-outs are queued.
+author: Li
+-----------------------------------------------------------------------*/
+int ev_run(struct evq *q, unsigned char *val)
+{
+	int i, v, n = 0;
+	while((i = evq_pop(q)) >= 0){
+		n++;
+		v = cnet_eval(q->c, val, i);
+		if(v != val[i]){
+			val[i] = v;
+			evq_fanout(q, i);
+		}
+	}
+	q->lo = q->c->nlev;
+	return n;
+}
+
+/* set word i to x, remember it for ev_wrestore and queue its fan-outs */
+void ev_wset(struct evq *q, uint64_t *w, int i, uint64_t x)
+{
+	if(w[i] == x) return;
+	w[i] = x;
+	q->touch[q->ntouch++] = i;
+	evq_fanout(q, i);
+}
+
+/*-----------------------------------------------------------------------
+input: queue, word values w, fault free words ref, optional and/or
+  masks forcing faulty bits, stop mask
+output: the stop bits in which some PO differs from ref
+called by: ppsfp_fault, tsim
+description: word selective trace. A gate is evaluated, forced through
+  its masks and only when its word changed are its fan-outs queued. The
+  differences are collected over all POs; the run ends early only when
+  every stop bit already shows one. With stop 0 the run always goes
+  until no events are left.
+author: Li
+-----------------------------------------------------------------------*/
+uint64_t ev_wrun(struct evq *q, uint64_t *w, const uint64_t *ref,
+	const uint64_t *andmk, const uint64_t *ormk, uint64_t stop)
+{
+	uint64_t x, det = 0;
+	int i;
+	while((i = evq_pop(q)) >= 0){
+		x = cnet_weval(q->c, w, i);
+		if(andmk) x = (x & andmk[i]) | ormk[i];
+		if(x == w[i]) continue;
+		if(q->ispo[i]) det |= (x ^ ref[i]) & stop;
+		if(stop && det == stop){
+			w[i] = x;
+			q->touch[q->ntouch++] = i;
+			evq_clear(q);
+			return det;
+		}
+		ev_wset(q, w, i, x);
+	}
+	q->lo = q->c->nlev;
+	return det;
+}
+
+/* undo every change since the last restore */
+void ev_wrestore(struct evq *q, uint64_t *w, const uint64_t *ref)
+{
+	int i;
+	for(i = 0; i < q->ntouch; i++) w[q->touch[i]] = ref[q->touch[i]];
+	q->ntouch = 0;
+}
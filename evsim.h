@@ -0,0 +1,41 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+/*-----------------------------------------------------------------------
+  event-driven selective trace
+
+  evq is a per-level bucket queue over a compiled netlist. Bucket l has
+  room for every node of level l (Levoff gives the sizes), a node is
+  queued at most once, and nodes come out level by level, so each gate
+  is evaluated at most once per run and only after all its changed
+  fan-ins. ev_run (0/1 values) and ev_wrun (64 bit words) evaluate the
+  queued gates and queue the fan-outs of every gate whose value changed,
+  until no events are left. Nodes changed by ev_wrun are recorded so the
+  caller can undo them with ev_wrestore.
+-----------------------------------------------------------------------*/
+struct evq {
+	const CNET *c;
+	int *buf;               /* bucket of level l starts at buf + levoff[l] */
+	int *cnt;               /* nodes queued per level */
+	unsigned char *mark;    /* node is queued */
+	int lo;                 /* no events below this level */
+	int nq;                 /* events queued */
+	int *touch;             /* nodes changed by ev_wrun */
+	int ntouch;
+	unsigned char *ispo;    /* 1 for primary outputs */
+};
+
+/*----------------- new function        ----------------------------------*/
+extern void evq_init(struct evq *q, const CNET *c);
+extern void evq_free(struct evq *q);
+extern void evq_push(struct evq *q, int i);
+extern int evq_pop(struct evq *q);
+extern void evq_fanout(struct evq *q, int i);
+extern void evq_clear(struct evq *q);
+extern int ev_run(struct evq *q, unsigned char *val);
+extern void ev_wset(struct evq *q, uint64_t *w, int i, uint64_t x);
+extern uint64_t ev_wrun(struct evq *q, uint64_t *w, const uint64_t *ref,
+	const uint64_t *andmk, const uint64_t *ormk, uint64_t stop);
+extern void ev_wrestore(struct evq *q, uint64_t *w, const uint64_t *ref);
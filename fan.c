@@ -0,0 +1,366 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "type.h"
+#include "netlist.h"
+#include "evsim.h"
+#include "atpg.h"
+#include "scoap.h"
+#include "fan.h"
+
+#define NFO(c, i) ((c)->fooff[(i) + 1] - (c)->fooff[i])
+
+/* non-controlling value of a gate type, the value that lets a D through */
+static int ncval(int t)
+{
+	return t == AND || t == NAND ? 1 : 0;
+}
+
+/* nearest common post-dominator of a and b */
+static int meet(const int *ipdom, int a, int b)
+{
+	while(a != b){
+		if(a < b) a = ipdom[a];
+		else b = ipdom[b];
+	}
+	return a;
+}
+
+/*-----------------------------------------------------------------------
+input: state with atpg set up
+output: nothing
+called by: fan_init
+description: a node is free when no fan-in cone line of it fans out or
+  is a PO, i.e. its cone is a tree over the PIs; a free node that feeds
+  a bound node (or a PO, or nothing) is a headline. Post-dominators are
+  found in reverse level order: fan-outs have larger indices, so the
+  immediate post-dominator of a node is the meet of its fan-outs, with
+  the POs meeting in the sink n.
+author: Li
+-----------------------------------------------------------------------*/
+static void prep(struct fan *p)
+{
+	const CNET *c = p->a.c;
+	const unsigned char *ispo = p->a.ispo;
+	unsigned char *fr = (unsigned char *) malloc(c->n);
+	int i, k, j, d;
+
+	for(i = 0; i < c->n; i++){
+		fr[i] = c->type[i] != BRCH;
+		for(k = c->fioff[i]; k < c->fioff[i + 1] && fr[i]; k++){
+			j = c->fi[k];
+			fr[i] = fr[j] && NFO(c, j) == 1 && !ispo[j];
+		}
+	}
+	for(i = 0; i < c->n; i++)
+		p->head[i] = fr[i] && (ispo[i] || NFO(c, i) != 1 || !fr[c->fo[c->fooff[i]]]);
+	free(fr);
+
+	for(i = c->n - 1; i >= 0; i--){
+		d = ispo[i] || NFO(c, i) == 0 ? c->n : -1;
+		for(k = c->fooff[i]; k < c->fooff[i + 1]; k++)
+			d = d < 0 ? c->fo[k] : meet(p->ipdom, d, c->fo[k]);
+		p->ipdom[i] = d;
+	}
+}
+
+void fan_init(struct fan *p, const CNET *c, long maxbt, double maxsec)
+{
+	atpg_init(&p->a, c);
+	p->cc0 = c->cc0;
+	p->cc1 = c->cc1;
+	p->head = (unsigned char *) malloc(c->n);
+	p->cut = (unsigned char *) calloc(c->n, 1);
+	p->tfo = (unsigned char *) malloc(c->n);
+	p->ipdom = (int *) malloc((c->n + 1) * sizeof(int));
+	p->n0 = (int *) malloc(c->n * sizeof(int));
+	p->n1 = (int *) malloc(c->n * sizeof(int));
+	p->pend = (unsigned char *) calloc(c->n, 1);
+	p->dnode = (int *) malloc((c->n + 1) * sizeof(int));
+	p->dval = (int *) malloc((c->n + 1) * sizeof(int));
+	p->dmark = (int *) malloc((c->n + 1) * sizeof(int));
+	p->dflip = (int *) malloc((c->n + 1) * sizeof(int));
+	p->maxbt = maxbt;
+	p->maxsec = maxsec;
+	p->a.cut = p->cut;
+	prep(p);
+}
+
+void fan_free(struct fan *p)
+{
+	atpg_free(&p->a);
+	free(p->head);
+	free(p->cut);
+	free(p->tfo);
+	free(p->ipdom);
+	free(p->n0);
+	free(p->n1);
+	free(p->pend);
+	free(p->dnode);
+	free(p->dval);
+	free(p->dmark);
+	free(p->dflip);
+}
+
+/* add c0 requests for 0 and c1 for 1 to X node j */
+static void want(struct fan *p, int j, int c0, int c1)
+{
+	if(p->a.v[j] != LX) return;
+	if(!p->pend[j]){
+		p->pend[j] = 1;
+		p->n0[j] = p->n1[j] = 0;
+		p->npend++;
+		if(j > p->hi) p->hi = j;
+	}
+	p->n0[j] += c0;
+	p->n1[j] += c1;
+}
+
+/* X fan-in of n easiest to set to b, or to either value if b is 2 */
+static int easiest(struct fan *p, int n, int b)
+{
+	const CNET *c = p->a.c;
+	int k, j, cc, best = -1, cost = 0;
+	for(k = c->fioff[n]; k < c->fioff[n + 1]; k++){
+		j = c->fi[k];
+		if(p->a.v[j] != LX) continue;
+		cc = b == 2 ? p->cc0[j] + p->cc1[j] : b ? p->cc1[j] : p->cc0[j];
+		if(best < 0 || cc < cost){
+			best = j;
+			cost = cc;
+		}
+	}
+	return best;
+}
+
+/*-----------------------------------------------------------------------
+input: state with the objectives queued by want
+output: 1 with a headline or PI in *n and its value in *b, 0 if
+  nothing was queued
+called by: fan
+description: multiple backtrace. Nodes are taken in decreasing index,
+  so a stem is reached only after all its branches have added their
+  counts; a stem outside the fault cone asked for both values keeps
+  only the larger count. A gate passes the requests for its controlled
+  value to the easiest X input and the others to every X input. Among
+  the headlines and PIs reached, the one with the most requests for a
+  value wins.
+author: Li
+-----------------------------------------------------------------------*/
+static int mbt(struct fan *p, int *n, int *b)
+{
+	struct atpg *a = &p->a;
+	const CNET *c = a->c;
+	int i, k, j, t, x0, x1, par, best = -1, cnt = 0;
+
+	for(i = p->hi; i >= 0 && p->npend; i--){
+		if(!p->pend[i]) continue;
+		p->pend[i] = 0;
+		p->npend--;
+		x0 = p->n0[i];
+		x1 = p->n1[i];
+		t = c->type[i];
+		if(t == IPT || p->cut[i]){
+			if(x0 > cnt || x1 > cnt || best < 0){
+				best = i;
+				*b = x1 > x0;
+				cnt = x1 > x0 ? x1 : x0;
+			}
+			continue;
+		}
+		if(x0 && x1 && NFO(c, i) > 1 && !p->tfo[i]){
+			/* stem asked for both values: the majority wins */
+			if(x1 > x0) x0 = 0;
+			else x1 = 0;
+		}
+		switch(t){
+			case BRCH:
+				want(p, c->fi[c->fioff[i]], x0, x1);
+				break;
+			case NOT:
+				want(p, c->fi[c->fioff[i]], x1, x0);
+				break;
+			case XOR:
+				for(par = 0, k = c->fioff[i]; k < c->fioff[i + 1]; k++)
+					if(a->v[c->fi[k]] != LX) par ^= L5G(a->v[c->fi[k]]);
+				j = easiest(p, i, 2);
+				if(par) want(p, j, x1, x0);
+				else want(p, j, x0, x1);
+				break;
+			default:
+				if(t == NAND || t == NOR){
+					k = x0;
+					x0 = x1;
+					x1 = k;
+				}
+				if(t == AND || t == NAND){
+					if(x0) want(p, easiest(p, i, 0), x0, 0);
+					if(x1)
+						for(k = c->fioff[i]; k < c->fioff[i + 1]; k++)
+							want(p, c->fi[k], 0, x1);
+				}
+				else{
+					if(x1) want(p, easiest(p, i, 1), 0, x1);
+					if(x0)
+						for(k = c->fioff[i]; k < c->fioff[i + 1]; k++)
+							want(p, c->fi[k], x0, 0);
+				}
+		}
+	}
+	p->hi = -1;
+	if(best < 0) return 0;
+	*n = best;
+	return 1;
+}
+
+/*-----------------------------------------------------------------------
+input: state
+output: 1 with objectives queued, 0 if there are none, -1 if unique
+  sensitization finds a dominator already blocked
+called by: fan
+description: activate the fault first. Once it is active, every X input
+  of every D-frontier gate with an X path wants its non-controlling
+  value. Unique sensitization: the dominators of those gates are gates
+  every propagation path has to pass, so an input of one outside the
+  fault cone at the controlling value blocks the fault for good, and
+  so does an X input whose non-controlling value a learned implication
+  (learn.c) rules out.
+author: Li
+-----------------------------------------------------------------------*/
+static int objectives(struct fan *p)
+{
+	struct atpg *a = &p->a;
+	const CNET *c = a->c;
+	int k, g, j, t, nc, d = -1;
+
+	if(a->v[a->fnode] == LX){
+		want(p, a->fnode, a->fval, !a->fval);
+		return 1;
+	}
+	for(k = 0; k < a->ndfr; k++){
+		g = a->dfr[k];
+		if(!atpg_xpath(a, g)) continue;
+		d = d < 0 ? g : meet(p->ipdom, d, g);
+		t = c->type[g];
+		for(j = c->fioff[g]; j < c->fioff[g + 1]; j++){
+			if(t != XOR) nc = ncval(t);
+			else nc = p->cc1[c->fi[j]] < p->cc0[c->fi[j]];
+			want(p, c->fi[j], !nc, nc);
+		}
+	}
+	if(d < 0) return 0;
+	for(; d < c->n; d = p->ipdom[d]){
+		t = c->type[d];
+		if(t == XOR || t == BRCH || t == NOT || a->dpos[d] >= 0) continue;
+		nc = ncval(t);
+		for(k = c->fioff[d]; k < c->fioff[d + 1]; k++){
+			j = c->fi[k];
+			if(p->tfo[j]) continue;
+			if(a->v[j] != LX ? L5G(a->v[j]) != nc : atpg_lconf(a, j, nc)) return -1;
+		}
+	}
+	return 1;
+}
+
+/* set the PIs of the fanout-free region of n so that n gets value b */
+static void justify(struct fan *p, int n, int b)
+{
+	const CNET *c = p->a.c;
+	int k, t, nc;
+
+	for(;;){
+		t = c->type[n];
+		if(t == IPT){
+			p->a.pin[n] = b;
+			return;
+		}
+		if(t == NOT || t == NAND || t == NOR) b = !b;
+		if(t == XOR){
+			for(k = c->fioff[n]; k < c->fioff[n + 1] - 1; k++)
+				justify(p, c->fi[k], 0);
+		}
+		else if(t != BRCH){
+			nc = t == AND || t == NAND;
+			if(b == nc)
+				for(k = c->fioff[n]; k < c->fioff[n + 1] - 1; k++)
+					justify(p, c->fi[k], b);
+		}
+		/* the last input carries what is left, any input will do */
+		n = c->fi[c->fioff[n + 1] - 1];
+	}
+}
+
+/*-----------------------------------------------------------------------
+input: state, FArr fault id, room for a vector of npi values
+output: T_DETECTED with the test cube in vec (2 for X), T_REDUNDANT
+  once the decision tree is exhausted, or T_ABORTED at the backtrack or
+  time limit
+called by: fangen
+description: FAN for one fault. The headlines outside the fault cone
+  (or at the fault site itself) are cut for this fault; a headline
+  inside the cone holds the fault in its region and is left to the
+  gates below it.
+author: Li
+-----------------------------------------------------------------------*/
+int fan(struct fan *p, int f, int *vec)
+{
+	struct atpg *a = &p->a;
+	const CNET *c = a->c;
+	clock_t start = clock();
+	int n, b, i, k, r;
+
+	memset(p->tfo, 0, c->n);
+	p->tfo[f / 2] = 1;
+	for(i = f / 2; i < c->n; i++)
+		if(p->tfo[i])
+			for(k = c->fooff[i]; k < c->fooff[i + 1]; k++) p->tfo[c->fo[k]] = 1;
+	for(i = 0; i < c->n; i++)
+		p->cut[i] = p->head[i] && c->type[i] != IPT && (!p->tfo[i] || i == f / 2);
+	atpg_fault(a, f);
+	p->nd = 0;
+	p->bt = 0;
+	p->hi = -1;
+	for(;;){
+		if(a->ndpo){
+			for(i = 0; i < c->n; i++)
+				if(p->cut[i] && a->pin[i] != LX) justify(p, i, a->pin[i]);
+			atpg_vector(a, vec);
+			return T_DETECTED;
+		}
+		r = atpg_conflict(a) ? -1 : objectives(p);
+		if(r < 0){
+			/* drop what was queued before unique sensitization failed */
+			for(i = p->hi; i >= 0; i--) p->pend[i] = 0;
+			p->npend = 0;
+			p->hi = -1;
+		}
+		if(r > 0 && mbt(p, &n, &b)){
+			p->dnode[p->nd] = n;
+			p->dval[p->nd] = b;
+			p->dmark[p->nd] = a->ntrail;
+			p->dflip[p->nd++] = 0;
+			atpg_pi(a, n, b);
+			continue;
+		}
+		/* backtrack to the latest decision that still has a branch */
+		for(;;){
+			if(p->nd == 0) return T_REDUNDANT;
+			i = p->nd - 1;
+			atpg_undo(a, p->dmark[i]);
+			if(!p->dflip[i]) break;
+			p->nd--;
+		}
+		if(++p->bt > p->maxbt || (p->maxsec > 0
+			&& (double) (clock() - start) / CLOCKS_PER_SEC > p->maxsec))
+			return T_ABORTED;
+		p->dflip[i] = 1;
+		p->dval[i] = !p->dval[i];
+		atpg_pi(a, p->dnode[i], p->dval[i]);
+	}
+}
@@ -0,0 +1,39 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+/*-----------------------------------------------------------------------
+  FAN test generation
+
+  Same search as PODEM, but the decisions are made on headlines, the
+  outputs of the fanout-free regions, as well as on PIs: a headline is
+  treated like a PI and its value is justified into its region only
+  after the test is found, which can never fail. Objectives come from
+  every D-frontier gate with an X path and are backtraced together
+  (multiple backtrace) as 0/1 request counts that stop at headlines; a
+  stem asked for both values follows the majority. The dominators every
+  propagation path has to pass (unique sensitization) must not have a
+  side input at the controlling value, else the search backtracks.
+-----------------------------------------------------------------------*/
+struct fan {
+	struct atpg a;
+	int *cc0, *cc1;         /* SCOAP controllability of the netlist */
+	unsigned char *head;    /* headline flags */
+	unsigned char *cut;     /* headlines decided for the current fault */
+	unsigned char *tfo;     /* fan-out cone of the fault site */
+	int *ipdom;             /* immediate post-dominator, n past the POs */
+	int *n0, *n1;           /* multiple backtrace request counts */
+	unsigned char *pend;
+	int npend, hi;
+	int *dnode, *dval, *dmark, *dflip;  /* decision stack */
+	int nd;
+	long maxbt;             /* backtrack limit per fault */
+	double maxsec;          /* time limit per fault, 0 for none */
+	long bt;                /* backtracks of the last fault */
+};
+
+/*----------------- new function        ----------------------------------*/
+extern void fan_init(struct fan *p, const CNET *c, long maxbt, double maxsec);
+extern void fan_free(struct fan *p);
+extern int fan(struct fan *p, int f, int *vec);
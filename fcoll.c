@@ -0,0 +1,90 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "type.h"
+#include "netlist.h"
+#include "fcoll.h"
+
+/* root of the class of f, halving the path on the way */
+static int find(int *p, int f)
+{
+	while(p[f] != f){
+		p[f] = p[p[f]];
+		f = p[f];
+	}
+	return f;
+}
+
+/* join the classes of a and b, the smaller FArr id stays the root */
+static void unite(int *p, int a, int b)
+{
+	a = find(p, a);
+	b = find(p, b);
+	if(a < b) p[b] = a;
+	else p[a] = b;
+}
+
+/*-----------------------------------------------------------------------
+input: netlist, rep and flist with room for every FArr fault
+output: number of faults in flist, the collapsed list from the highest
+  FArr id down; rep[f] is the representative of the class of fault f
+called by: initFArr
+description: a fault free input j of gate i is a line that only feeds i
+  and is no PO, its faults are the faults of the gate input. Then for
+  AND/NAND (OR/NOR) j s-a-0 (s-a-1) is equivalent to the output stuck
+  at the controlled value, for NOT and BRCH (and one input gates) both
+  faults of j follow the output. XOR has no equivalent faults. The
+  output stuck at the other value dominates j stuck at the non-
+  controlling value and is left out of flist with its whole class.
+  Dominance only points from inputs to outputs, so what is left out is
+  always covered by a class that stays.
+author: Li
+-----------------------------------------------------------------------*/
+int fcoll(const CNET *c, int *rep, int *flist)
+{
+	unsigned char *ispo = (unsigned char *) calloc(c->n + 1, 1);
+	unsigned char *dom = (unsigned char *) calloc(2 * c->n + 1, 1);
+	unsigned char *ffi = (unsigned char *) calloc(c->n + 1, 1);
+	int i, j, k, t, cv, inv, nin, f, nf = 0;
+
+	for(k = 0; k < c->npo; k++) ispo[c->po[k]] = 1;
+	for(f = 0; f < 2 * c->n; f++) rep[f] = f;
+	for(i = 0; i < c->n; i++){
+		t = c->type[i];
+		nin = c->fioff[i + 1] - c->fioff[i];
+		if(t == IPT || t == XOR) continue;
+		cv = t == OR || t == NOR;
+		inv = t == NAND || t == NOR || t == NOT;
+		for(k = c->fioff[i]; k < c->fioff[i + 1]; k++){
+			j = c->fi[k];
+			if(c->fooff[j + 1] - c->fooff[j] != 1 || ispo[j]) continue;
+			if(t == BRCH || t == NOT || nin == 1){
+				unite(rep, 2 * j, 2 * i + inv);
+				unite(rep, 2 * j + 1, 2 * i + !inv);
+			}
+			else{
+				unite(rep, 2 * j + cv, 2 * i + (cv ^ inv));
+				ffi[i] = 1;
+			}
+		}
+	}
+	/* the output stuck at the non-controlled value dominates */
+	for(i = 0; i < c->n; i++){
+		if(!ffi[i]) continue;
+		t = c->type[i];
+		cv = t == OR || t == NOR;
+		inv = t == NAND || t == NOR;
+		dom[find(rep, 2 * i + (!cv ^ inv))] = 1;
+	}
+	for(f = 0; f < 2 * c->n; f++) rep[f] = find(rep, f);
+	for(f = 2 * c->n - 1; f >= 0; f--)
+		if(rep[f] == f && !dom[f]) flist[nf++] = f;
+	free(ispo);
+	free(dom);
+	free(ffi);
+	return nf;
+}
@@ -0,0 +1,18 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+/*-----------------------------------------------------------------------
+  structural fault collapsing
+
+  One pass over the compiled netlist puts equivalent faults in the same
+  union-find class: the input and output faults of a gate that a test
+  cannot tell apart, wherever the input line feeds only that gate and is
+  not a PO. A second pass drops the classes that dominate another one,
+  the output fault a test for a non-controlling input fault always
+  detects. Both passes are O(nodes + edges) for any fan-in.
+-----------------------------------------------------------------------*/
+
+/*----------------- new function        ----------------------------------*/
+extern int fcoll(const CNET *c, int *rep, int *flist);
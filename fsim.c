@@ -0,0 +1,121 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "type.h"
+#include "netlist.h"
+#include "evsim.h"
+#include "pstore.h"
+#include "fsim.h"
+
+void ppsfp_init(struct ppsfp *s, const CNET *c)
+{
+	s->c = c;
+	s->good = cnet_walloc(c, 1);
+	s->fw = cnet_walloc(c, 1);
+	s->piw = (uint64_t *) malloc((c->npi + 1) * sizeof(uint64_t));
+	evq_init(&s->q, c);
+}
+
+void ppsfp_free(struct ppsfp *s)
+{
+	free(s->good);
+	free(s->fw);
+	free(s->piw);
+	evq_free(&s->q);
+}
+
+/*-----------------------------------------------------------------------
+input: state, one 64 pattern word per PI in Pinput order
+output: nothing
+called by: ppsfp_load, rpt
+description: simulate the fault free circuit. The faulty machine starts
+  as a copy of it.
+author: Li
+-----------------------------------------------------------------------*/
+void ppsfp_wload(struct ppsfp *s, const uint64_t *piw)
+{
+	const CNET *c = s->c;
+	int i;
+	for(i = 0; i < c->npi; i++) s->good[c->pi[i]] = piw[i];
+	cnet_wsim(c, s->good, 1);
+	memcpy(s->fw, s->good, c->n * sizeof(uint64_t));
+}
+
+/* load vectors base..base+nb-1 of the store, vector base+b into bit b */
+void ppsfp_load(struct ppsfp *s, const struct pstore *ps, int base, int nb)
+{
+	ps_transpose(ps, base, nb, s->piw);
+	ppsfp_wload(s, s->piw);
+}
+
+/*-----------------------------------------------------------------------
+input: state loaded by ppsfp_load, fault id, mask of patterns to check
+output: the patterns of valid that detect the fault
+called by: ppsfp
+description: inject the fault and trace it through its fan-out cone
+  with ev_wrun. Only gates with a changed fan-in are evaluated, and the
+  differences of all POs are collected, so every pattern of valid that
+  detects the fault is in the result; the run only ends early once all
+  of valid does. The faulty machine is restored before returning.
+author: Li
+-----------------------------------------------------------------------*/
+uint64_t ppsfp_fault(struct ppsfp *s, int f, uint64_t valid)
+{
+	int n = f / 2;
+	uint64_t x, det = 0;
+
+	x = f % 2 ? ~0ULL : 0;
+	if(((x ^ s->good[n]) & valid) == 0) return 0;   /* not activated */
+	if(s->q.ispo[n]) det = (x ^ s->good[n]) & valid;
+	if(!det){
+		ev_wset(&s->q, s->fw, n, x);
+		det = ev_wrun(&s->q, s->fw, s->good, NULL, NULL, valid);
+	}
+	ev_wrestore(&s->q, s->fw, s->good);
+	return det;
+}
+
+/*-----------------------------------------------------------------------
+input: netlist, pattern store, fault list
+output: number of detected faults; detvec[k] is the first vector that
+  detects flist[k], or -1
+called by: PPSFP_client
+description: PPSFP with fault dropping. Vectors go 64 at a time; a
+  fault leaves the active list as soon as one vector detects it.
+author: Li
+-----------------------------------------------------------------------*/
+int ppsfp(const CNET *c, const struct pstore *ps, const int *flist, int nf, int *detvec)
+{
+	struct ppsfp s;
+	int *act = (int *) malloc((nf + 1) * sizeof(int));
+	int nvec = ps->n, na = 0, nd = 0, base, nb, k, j;
+	uint64_t valid, det;
+
+	for(k = 0; k < nf; k++){
+		detvec[k] = -1;
+		act[na++] = k;
+	}
+	ppsfp_init(&s, c);
+	for(base = 0; base < nvec && na; base += 64){
+		nb = nvec - base < 64 ? nvec - base : 64;
+		valid = nb == 64 ? ~0ULL : (1ULL << nb) - 1;
+		ppsfp_load(&s, ps, base, nb);
+		for(j = k = 0; k < na; k++){
+			det = ppsfp_fault(&s, flist[act[k]], valid);
+			if(det){
+				detvec[act[k]] = base + __builtin_ctzll(det);
+				nd++;
+			}
+			else act[j++] = act[k];   /* keep undetected faults */
+		}
+		na = j;
+	}
+	ppsfp_free(&s);
+	free(act);
+	return nd;
+}
@@ -0,0 +1,29 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+/*-----------------------------------------------------------------------
+  parallel-pattern single-fault propagation (PPSFP)
+
+  64 vectors are simulated fault free at once; each fault is then
+  injected on its own and propagated only through its fan-out cone,
+  64 patterns per word. Fault ids are FArr indices: fault f is stuck-at
+  f%2 on compiled node f/2. Vectors come from a pattern store (pstore.h)
+  and are loaded transposed, 64 to a word.
+-----------------------------------------------------------------------*/
+struct ppsfp {
+	const CNET *c;
+	uint64_t *good;         /* fault free words, one per node */
+	uint64_t *fw;           /* faulty machine, equal to good outside the cone */
+	uint64_t *piw;          /* PI words of the block ppsfp_load transposes */
+	struct evq q;           /* event queue of the faulty machine */
+};
+
+/*----------------- new function        ----------------------------------*/
+extern void ppsfp_init(struct ppsfp *s, const CNET *c);
+extern void ppsfp_free(struct ppsfp *s);
+extern void ppsfp_wload(struct ppsfp *s, const uint64_t *piw);
+extern void ppsfp_load(struct ppsfp *s, const struct pstore *ps, int base, int nb);
+extern uint64_t ppsfp_fault(struct ppsfp *s, int f, uint64_t valid);
+extern int ppsfp(const CNET *c, const struct pstore *ps, const int *flist, int nf, int *detvec);
@@ -0,0 +1,171 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "type.h"
+#include "netlist.h"
+#include "learn.h"
+
+/* implication state, set[] doubles as the queue of nodes to visit */
+struct limp {
+	const CNET *c;
+	unsigned char *v;       /* 0, 1 or 2 for X */
+	int *set, nset, head;
+};
+
+/* give node n value b, 0 on a conflict */
+static int assign(struct limp *L, int n, int b)
+{
+	if(L->v[n] == b) return 1;
+	if(L->v[n] != 2) return 0;
+	L->v[n] = b;
+	L->set[L->nset++] = n;
+	return 1;
+}
+
+/* value of gate g from its fan-ins, 2 if they leave it open */
+static int fwd(const struct limp *L, int g)
+{
+	const CNET *c = L->c;
+	int t = c->type[g], k, x, y, any = 0, cv;
+
+	if(t == IPT) return 2;
+	if(t == BRCH || t == NOT){
+		x = L->v[c->fi[c->fioff[g]]];
+		return t == NOT && x != 2 ? !x : x;
+	}
+	if(t == XOR){
+		for(y = 0, k = c->fioff[g]; k < c->fioff[g + 1]; k++){
+			if((x = L->v[c->fi[k]]) == 2) return 2;
+			y ^= x;
+		}
+		return y;
+	}
+	cv = t == OR || t == NOR;
+	for(k = c->fioff[g]; k < c->fioff[g + 1]; k++){
+		x = L->v[c->fi[k]];
+		if(x == cv) return cv ^ (t == NAND || t == NOR);
+		any |= x == 2;
+	}
+	return any ? 2 : !cv ^ (t == NAND || t == NOR);
+}
+
+/* fan-in values forced by the value of gate g, 0 on a conflict */
+static int bwd(struct limp *L, int g)
+{
+	const CNET *c = L->c;
+	int t = c->type[g], y = L->v[g], k, x, nx = 0, xk = -1, cv, par = 0;
+
+	if(y == 2 || t == IPT) return 1;
+	if(t == BRCH || t == NOT) return assign(L, c->fi[c->fioff[g]], t == NOT ? !y : y);
+	if(t == XOR){
+		for(k = c->fioff[g]; k < c->fioff[g + 1]; k++){
+			if((x = L->v[c->fi[k]]) == 2){
+				nx++;
+				xk = c->fi[k];
+			}
+			else par ^= x;
+		}
+		return nx != 1 || assign(L, xk, y ^ par);
+	}
+	cv = t == OR || t == NOR;
+	if((y ^ (t == NAND || t == NOR)) != cv){    /* every input non-controlling */
+		for(k = c->fioff[g]; k < c->fioff[g + 1]; k++)
+			if(!assign(L, c->fi[k], !cv)) return 0;
+		return 1;
+	}
+	for(k = c->fioff[g]; k < c->fioff[g + 1]; k++){
+		x = L->v[c->fi[k]];
+		if(x == cv) return 1;
+		if(x == 2){
+			nx++;
+			xk = c->fi[k];
+		}
+	}
+	if(nx == 0) return 0;
+	return nx > 1 || assign(L, xk, cv);
+}
+
+/* imply node i = b, 0 on a conflict; the nodes set are in L->set */
+static int imply(struct limp *L, int i, int b)
+{
+	const CNET *c = L->c;
+	int n, k, g, y;
+
+	L->nset = L->head = 0;
+	assign(L, i, b);
+	while(L->head < L->nset){
+		n = L->set[L->head++];
+		if(!bwd(L, n)) return 0;
+		for(k = c->fooff[n]; k < c->fooff[n + 1]; k++){
+			g = c->fo[k];
+			if((y = fwd(L, g)) != 2 && !assign(L, g, y)) return 0;
+			if(!bwd(L, g)) return 0;
+		}
+	}
+	return 1;
+}
+
+/*-----------------------------------------------------------------------
+input: compiled netlist
+output: number of learned implications, stored in c->lnoff/c->lrn
+called by: cread
+description: for node i = b, every implied node m after i (so i does
+  not depend on m) that is an AND, NAND, OR or NOR gate of two or more
+  inputs at its non-controlled value gives "m = !w implies i = !b". A
+  gate at its controlled value forces none of its inputs and i is not
+  in the fan-out cone of m, so direct implication never finds these.
+  Assignments that end in a conflict learn nothing.
+author: Li
+-----------------------------------------------------------------------*/
+int learn(CNET *c)
+{
+	struct limp L;
+	int *ante = NULL, *cons = NULL, cap = 0, nl = 0;
+	int i, b, k, m, t, w, nc;
+
+	L.c = c;
+	L.v = (unsigned char *) malloc(c->n + 1);
+	L.set = (int *) malloc((c->n + 1) * sizeof(int));
+	for(i = 0; i < c->n; i++) L.v[i] = 2;
+	for(i = 0; i < c->n; i++)
+		for(b = 0; b < 2; b++){
+			if(imply(&L, i, b))
+				for(k = 1; k < L.nset; k++){
+					m = L.set[k];
+					t = c->type[m];
+					if(m < i || t < OR || t == NOT || c->fioff[m + 1] - c->fioff[m] < 2)
+						continue;
+					w = L.v[m];
+					nc = !(t == OR || t == NOR) ^ (t == NAND || t == NOR);
+					if(w != nc) continue;
+					if(nl == cap){
+						cap = cap ? 2 * cap : 1024;
+						ante = (int *) realloc(ante, cap * sizeof(int));
+						cons = (int *) realloc(cons, cap * sizeof(int));
+					}
+					ante[nl] = 2 * m + !w;
+					cons[nl++] = 2 * i + !b;
+				}
+			for(k = 0; k < L.nset; k++) L.v[L.set[k]] = 2;
+		}
+	/* CSR by antecedent literal */
+	free(c->lnoff);
+	free(c->lrn);
+	c->lnoff = (int *) calloc(2 * c->n + 1, sizeof(int));
+	c->lrn = (int *) malloc((nl + 1) * sizeof(int));
+	c->nlrn = nl;
+	for(k = 0; k < nl; k++) c->lnoff[ante[k] + 1]++;
+	for(k = 0; k < 2 * c->n; k++) c->lnoff[k + 1] += c->lnoff[k];
+	for(k = 0; k < nl; k++) c->lrn[c->lnoff[ante[k]]++] = cons[k];
+	for(k = 2 * c->n; k > 0; k--) c->lnoff[k] = c->lnoff[k - 1];
+	c->lnoff[0] = 0;
+	free(ante);
+	free(cons);
+	free(L.v);
+	free(L.set);
+	return nl;
+}
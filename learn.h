@@ -0,0 +1,19 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+/*-----------------------------------------------------------------------
+  static learning (SOCRATES)
+
+  Every node is set to 0 and to 1 in turn and the assignment is implied
+  through the fault free circuit with 3-valued logic, forward and
+  backward wherever one value is forced. If node i = b implies that a
+  later AND/OR type gate m takes the value all its inputs must agree on,
+  the contrapositive "m at its controlled value implies i = !b" is one
+  no direct implication finds, so it is kept in the netlist (lnoff/lrn,
+  see netlist.h) for the test generators.
+-----------------------------------------------------------------------*/
+
+/*----------------- new function        ----------------------------------*/
+extern int learn(CNET *c);
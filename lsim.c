@@ -0,0 +1,238 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "netlist.h"
+#include "pstore.h"
+#include "lsim.h"
+
+/* planes of one pattern for npi PIs */
+static uint64_t *palloc(int npi)
+{
+	return (uint64_t *) calloc(2 * ((npi + 63) / 64) + 1, sizeof(uint64_t));
+}
+
+/* count patterns from first, in Gray code if gray is set */
+void ls_count(struct lsrc *s, int npi, int gray, unsigned long long first,
+	unsigned long long count)
+{
+	memset(s, 0, sizeof(*s));
+	s->kind = gray ? LS_GRAY : LS_COUNT;
+	s->npi = npi;
+	s->next = first;
+	s->left = count;
+}
+
+/* patterns from the file name, returns 0 if it cannot be read */
+int ls_file(struct lsrc *s, int npi, const char *name)
+{
+	memset(s, 0, sizeof(*s));
+	s->kind = LS_FILE;
+	s->npi = npi;
+	if((s->fp = fopen(name, "r")) == NULL) return 0;
+	s->p = palloc(npi);
+	return 1;
+}
+
+void ls_close(struct lsrc *s)
+{
+	if(s->fp) fclose(s->fp);
+	free(s->line);
+	free(s->p);
+	memset(s, 0, sizeof(*s));
+}
+
+/* the pattern of the line read last into s->p, 0 if it has none */
+static int parse(struct lsrc *s, int nw)
+{
+	char *q = strstr(s->line, "Test:");
+	int i;
+
+	q = q ? q + 5 : s->line;
+	while(*q == ' ' || *q == '\t') q++;
+	memset(s->p, 0, 2 * nw * sizeof(uint64_t));
+	for(i = 0; i < s->npi; i++, q++){
+		if(*q == 'X' || *q == 'x') continue;
+		if(*q != '0' && *q != '1') return 0;
+		s->p[nw + (i >> 6)] |= 1ULL << (i & 63);
+		if(*q == '1') s->p[i >> 6] |= 1ULL << (i & 63);
+	}
+	return 1;
+}
+
+/* bit j is bit i of j, for the 6 low counter bits */
+static const uint64_t lowbit[6] = {
+	0xaaaaaaaaaaaaaaaaULL, 0xccccccccccccccccULL, 0xf0f0f0f0f0f0f0f0ULL,
+	0xff00ff00ff00ff00ULL, 0xffff0000ffff0000ULL, 0xffffffff00000000ULL
+};
+
+/* word of counter bit i over the 64 counts from v: bit j is bit i of
+   v+j. The counts lie in the aligned blocks a = v&~63 and a+64; the low
+   6 bits run through j+k (mod 64), the others are those of a up to the
+   carry at j = 64-k, then those of a+64. */
+static uint64_t cword(unsigned long long v, int i)
+{
+	unsigned long long a = v & ~63ULL;
+	int k = v & 63;
+	uint64_t lo = k ? (1ULL << (64 - k)) - 1 : ~0ULL;
+
+	if(i >= 64) return 0;
+	if(i < 6) return k ? lowbit[i] >> k | lowbit[i] << (64 - k) : lowbit[i];
+	return (a >> i & 1 ? lo : 0) | ((a + 64) >> i & 1 ? ~lo : 0);
+}
+
+/*-----------------------------------------------------------------------
+input: source, scratch store for npi PIs, one word per PI
+output: the next patterns (at most 64), pattern j in bit j of piw[i]
+  for PI i; 0 once the source is done
+called by: lsim
+description: the counters write their words straight from the count
+  with cword, Gray code as bit i ^ bit i+1. File patterns are packed
+  into ps and turned into words with ps_transpose.
+author: Li
+-----------------------------------------------------------------------*/
+int ls_words(struct lsrc *s, struct pstore *ps, uint64_t *piw)
+{
+	uint64_t m, x;
+	int nb, i;
+
+	if(s->kind == LS_FILE){
+		ps->n = 0;
+		while(ps->n < 64 && getline(&s->line, &s->cap, s->fp) >= 0)
+			if(parse(s, ps->nw)) ps_addp(ps, s->p, -1);
+		ps_transpose(ps, 0, ps->n, piw);
+		return ps->n;
+	}
+	nb = s->left < 64 ? s->left : 64;
+	m = nb == 64 ? ~0ULL : (1ULL << nb) - 1;
+	for(x = cword(s->next, 0), i = 0; i < s->npi; i++){
+		piw[i] = x;
+		x = cword(s->next, i + 1);
+		if(s->kind == LS_GRAY) piw[i] ^= x;
+		piw[i] &= m;
+	}
+	s->next += nb;
+	s->left -= nb;
+	return nb;
+}
+
+/* write into the file name through a buffer of cap bytes, 0 on failure */
+int lk_open(struct lsink *k, const char *name, size_t cap)
+{
+	memset(k, 0, sizeof(*k));
+	if((k->fd = open(name, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0) return 0;
+	k->cap = cap;
+	k->buf = (char *) malloc(cap);
+	return 1;
+}
+
+/* write the buffer out, short writes are continued; 0 on failure with
+   the errno in k->err, and after a failure nothing is written any more */
+int lk_flush(struct lsink *k)
+{
+	size_t off = 0;
+	ssize_t r;
+	while(off < k->n && k->err == 0){
+		r = write(k->fd, k->buf + off, k->n - off);
+		if(r < 0 && errno == EINTR) continue;
+		if(r <= 0) k->err = r < 0 ? errno : EIO;
+		else off += r;
+	}
+	k->bytes += off;
+	k->n = 0;
+	return k->err == 0;
+}
+
+/* room for len more bytes at k->buf + k->n; the caller adds len to n */
+char *lk_room(struct lsink *k, size_t len)
+{
+	if(k->n + len > k->cap) lk_flush(k);
+	if(len > k->cap){
+		k->cap = len;
+		k->buf = (char *) realloc(k->buf, len);
+	}
+	return k->buf + k->n;
+}
+
+/* flush and close, 0 if any write or the close failed (k->err) */
+int lk_close(struct lsink *k)
+{
+	lk_flush(k);
+	if(close(k->fd) != 0 && k->err == 0) k->err = errno;
+	free(k->buf);
+	k->buf = NULL;
+	return k->err == 0;
+}
+
+/*-----------------------------------------------------------------------
+input: netlist, pattern source, sink, enum e_lfmt format, lanes of
+  cnet_wsim (1, 4 or 8)
+output: number of patterns simulated
+called by: logic
+description: per block every lane takes the next 64 patterns from
+  ls_words, already one word per PI, the block is simulated, and the PO
+  words are written out, bit by bit for LF_TEXT and as they are for
+  LF_BIN. The run stops early once the sink fails.
+author: Li
+-----------------------------------------------------------------------*/
+unsigned long long lsim(const CNET *c, struct lsrc *s, struct lsink *k, int fmt,
+	int lanes)
+{
+	struct pstore ps;
+	uint64_t *w = cnet_walloc(c, lanes), *piw, m, x;
+	unsigned long long tot = 0;
+	size_t len = c->npi + c->npo + 8;
+	int nb, i, j, l, b;
+	char *q;
+
+	ps_init(&ps, c->npi);
+	piw = (uint64_t *) malloc((64 * ps.nw + 1) * sizeof(uint64_t));
+	if(fmt == LF_TEXT){
+		q = lk_room(k, 64);
+		k->n += sprintf(q, "Primary Inputs: ->>>>>>>>>>>\t\t\t\t\tPrimary outputs:\n");
+	}
+	for(;;){
+		for(nb = l = 0; l < lanes; l++){
+			j = nb == 64 * l ? ls_words(s, &ps, piw) : 0;
+			for(i = 0; i < c->npi; i++) w[c->pi[i] * lanes + l] = j ? piw[i] : 0;
+			nb += j;
+		}
+		if(nb == 0 || k->err) break;
+		cnet_wsim(c, w, lanes);
+		if(fmt == LF_BIN)
+			for(l = 0; 64 * l < nb; l++){
+				m = nb - 64 * l >= 64 ? ~0ULL : (1ULL << (nb - 64 * l)) - 1;
+				q = lk_room(k, 8 * c->npo);
+				for(i = 0; i < c->npo; i++){
+					x = w[c->po[i] * lanes + l] & m;
+					memcpy(q + 8 * i, &x, 8);
+				}
+				k->n += 8 * c->npo;
+			}
+		else
+			for(j = 0; j < nb; j++){
+				l = j >> 6;
+				b = j & 63;
+				q = lk_room(k, len);
+				for(i = c->npi - 1; i >= 0; i--) *q++ = '0' + (w[c->pi[i] * lanes + l] >> b & 1);
+				memcpy(q, "\t\t\t\t\t\t\t", 7);
+				q += 7;
+				for(i = 0; i < c->npo; i++) *q++ = '0' + (w[c->po[i] * lanes + l] >> b & 1);
+				*q = '\n';
+				k->n += len;
+			}
+		tot += nb;
+	}
+	ps_free(&ps);
+	free(piw);
+	free(w);
+	return tot;
+}
@@ -0,0 +1,62 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+/*-----------------------------------------------------------------------
+  streaming logic simulation
+
+  lsim() pulls blocks of 64*lanes patterns from a source, simulates
+  them with cnet_wsim and pushes the PO responses into a sink, so the
+  number of patterns is bounded only by the 64 bit counter. A source is
+  the input counter from any start (LS_COUNT), the same counter in Gray
+  code so one PI changes between neighbours (LS_GRAY), or a pattern
+  file read one block at a time (LS_FILE). A file line gives the PIs
+  with PI 0 first as 0, 1 or X (read as 0); a "Test:" field is read
+  from, so Dal.txt can be replayed, and lines without npi such
+  characters are skipped. Counter patterns give PI i bit i of the
+  count, PIs from 64 on stay 0; their PI words are made straight from
+  the count, 64 patterns at a time.
+
+  The sink gathers the output in a large buffer that goes out with one
+  write(2) when full. A failed or short write is kept in err, and
+  lk_flush and lk_close report it. LF_TEXT is the output.txt format of LOGIC, one line
+  per pattern with the PIs from the last and the POs from the first.
+  LF_BIN writes npo 64 bit words per 64 patterns, pattern 64*k+b of the
+  run in bit b of the words of block k, in host byte order; the bits
+  past the last pattern are 0.
+-----------------------------------------------------------------------*/
+enum e_lsrc {LS_COUNT, LS_GRAY, LS_FILE};
+enum e_lfmt {LF_TEXT, LF_BIN};
+
+struct lsrc {
+	int kind;               /* enum e_lsrc */
+	int npi;
+	unsigned long long next;        /* counter value of the next pattern */
+	unsigned long long left;        /* patterns still to come, counter only */
+	FILE *fp;
+	char *line;
+	size_t cap;
+	uint64_t *p;            /* the planes of one file pattern */
+};
+
+struct lsink {
+	int fd;
+	char *buf;
+	size_t n, cap;
+	unsigned long long bytes;       /* written so far */
+	int err;                /* errno of the first failure, 0 if none */
+};
+
+/*----------------- new function        ----------------------------------*/
+extern void ls_count(struct lsrc *s, int npi, int gray, unsigned long long first,
+	unsigned long long count);
+extern int ls_file(struct lsrc *s, int npi, const char *name);
+extern int ls_words(struct lsrc *s, struct pstore *ps, uint64_t *piw);
+extern void ls_close(struct lsrc *s);
+extern int lk_open(struct lsink *k, const char *name, size_t cap);
+extern char *lk_room(struct lsink *k, size_t len);
+extern int lk_flush(struct lsink *k);
+extern int lk_close(struct lsink *k);
+extern unsigned long long lsim(const CNET *c, struct lsrc *s, struct lsink *k, int fmt,
+	int lanes);
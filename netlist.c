@@ -0,0 +1,278 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include "type.h"
+#include "netlist.h"
+#include "tape.h"
+
+/*-----------------------------------------------------------------------
+input: node, edge, PI, PO and level counts
+output: empty compiled netlist
+called by: compile
+description: allocate every column of the compiled netlist. fo has the
+  same number of entries as fi since every edge is seen from both sides.
+author: Li
+-----------------------------------------------------------------------*/
+CNET *cnet_new(int n, int nfi, int npi, int npo, int nlev)
+{
+	CNET *c = (CNET *) calloc(1, sizeof(CNET));
+	c->n = n;
+	c->nfi = nfi;
+	c->npi = npi;
+	c->npo = npo;
+	c->nlev = nlev;
+	c->type = (unsigned char *) malloc(n * sizeof(unsigned char));
+	c->level = (int *) malloc(n * sizeof(int));
+	c->num = (int *) malloc(n * sizeof(int));
+	c->fioff = (int *) malloc((n + 1) * sizeof(int));
+	c->fi = (int *) malloc((nfi + 1) * sizeof(int));
+	c->fooff = (int *) malloc((n + 1) * sizeof(int));
+	c->fo = (int *) malloc((nfi + 1) * sizeof(int));
+	c->pi = (int *) malloc((npi + 1) * sizeof(int));
+	c->po = (int *) malloc((npo + 1) * sizeof(int));
+	c->levoff = (int *) malloc((nlev + 1) * sizeof(int));
+	c->ord = (int *) malloc(n * sizeof(int));
+	c->val = (unsigned char *) calloc(n, sizeof(unsigned char));
+	return c;
+}
+
+void cnet_free(CNET *c)
+{
+	if(c == NULL) return;
+	if(c->dl) dlclose(c->dl);
+	tape_free(c->tape);
+	free(c->val);
+	if(c->map){     /* columns live in a mapped circuit image */
+		munmap(c->map, c->maplen);
+		free(c);
+		return;
+	}
+	free(c->type);
+	free(c->level);
+	free(c->num);
+	free(c->fioff);
+	free(c->fi);
+	free(c->fooff);
+	free(c->fo);
+	free(c->pi);
+	free(c->po);
+	free(c->levoff);
+	free(c->ord);
+	free(c->lnoff);
+	free(c->lrn);
+	free(c->cc0);
+	free(c->cc1);
+	free(c->co);
+	free(c);
+}
+
+/*-----------------------------------------------------------------------
+input: compiled netlist with fioff/fi filled
+output: nothing
+called by: compile
+description: derive the fan-out CSR from the fan-in CSR by counting sort.
+  Fan-outs of a node end up in increasing node order.
+author: Li
+-----------------------------------------------------------------------*/
+void cnet_fanout(CNET *c)
+{
+	int i, k;
+	for(i = 0; i <= c->n; i++) c->fooff[i] = 0;
+	for(k = 0; k < c->nfi; k++) c->fooff[c->fi[k] + 1]++;
+	for(i = 0; i < c->n; i++) c->fooff[i + 1] += c->fooff[i];
+	/* fill using fooff[i] as cursor, then shift back */
+	for(i = 0; i < c->n; i++)
+		for(k = c->fioff[i]; k < c->fioff[i + 1]; k++)
+			c->fo[c->fooff[c->fi[k]]++] = i;
+	for(i = c->n; i > 0; i--) c->fooff[i] = c->fooff[i - 1];
+	c->fooff[0] = 0;
+}
+
+/*-----------------------------------------------------------------------
+input: netlist, value column, node
+output: value of the node computed from its fan-ins
+called by: cnet_sim and the fault simulators
+description: gates of any fan-in are evaluated as one n-input gate.
+author: Li
+-----------------------------------------------------------------------*/
+int cnet_eval(const CNET *c, const unsigned char *val, int i)
+{
+	const int *p = c->fi + c->fioff[i];
+	const int *e = c->fi + c->fioff[i + 1];
+	int v;
+
+	switch(c->type[i]){
+		case BRCH: return val[*p];
+		case NOT: return !val[*p];
+		case XOR:
+			for(v = 0; p < e; p++) v ^= val[*p];
+			return v;
+		case OR:
+		case NOR:
+			for(v = 0; p < e && !v; p++) v = val[*p];
+			return c->type[i] == OR ? v : !v;
+		case AND:
+		case NAND:
+			for(v = 1; p < e && v; p++) v = val[*p];
+			return c->type[i] == AND ? v : !v;
+	}
+	return val[i];
+}
+
+/* fault free logic simulation, the PI values must already be in val */
+void cnet_sim(const CNET *c, unsigned char *val)
+{
+	int i;
+	if(c->tape){
+		tape_sim(c->tape, val);
+		return;
+	}
+	for(i = c->levoff[1]; i < c->n; i++)
+		val[i] = cnet_eval(c, val, i);
+}
+
+/*-----------------------------------------------------------------------
+  bit-parallel pattern simulation
+
+  Each node holds 64*lanes patterns, lanes consecutive 64 bit words, so
+  every gate is evaluated once per block of patterns. The 4 and 8 lane
+  versions are compiled for AVX2 and AVX-512 with the GCC vector
+  extension and only run when the CPU has those units; otherwise the
+  same source is compiled for the baseline instruction set.
+-----------------------------------------------------------------------*/
+typedef uint64_t v4w __attribute__((vector_size(32)));
+typedef uint64_t v8w __attribute__((vector_size(64)));
+
+#define DEF_WSIM(name, W, attr) \
+attr static void name(const CNET *c, W *v) \
+{ \
+	const int *p, *e; \
+	int i, t; \
+	W x; \
+	for(i = c->levoff[1]; i < c->n; i++){ \
+		p = c->fi + c->fioff[i]; \
+		e = c->fi + c->fioff[i + 1]; \
+		t = c->type[i]; \
+		x = v[*p++]; \
+		switch(t){ \
+			case NOT: x = ~x; break; \
+			case XOR: while(p < e) x ^= v[*p++]; break; \
+			case OR: \
+			case NOR: \
+				while(p < e) x |= v[*p++]; \
+				if(t == NOR) x = ~x; \
+				break; \
+			case AND: \
+			case NAND: \
+				while(p < e) x &= v[*p++]; \
+				if(t == NAND) x = ~x; \
+				break; \
+		} \
+		v[i] = x; \
+	} \
+}
+
+DEF_WSIM(wsim1, uint64_t, )
+DEF_WSIM(wsim4, v4w, )
+DEF_WSIM(wsim8, v8w, )
+DEF_WSIM(wsim4_avx2, v4w, __attribute__((target("avx2"))))
+DEF_WSIM(wsim8_avx512, v8w, __attribute__((target("avx512f"))))
+
+static int Hwlanes;
+static pthread_once_t Hwonce = PTHREAD_ONCE_INIT;
+
+static void hwdetect()
+{
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx512f")) Hwlanes = 8;
+	else if(__builtin_cpu_supports("avx2")) Hwlanes = 4;
+	else Hwlanes = 1;
+}
+
+/* lanes the CPU runs natively: 8 with AVX-512, 4 with AVX2, else 1. The
+   CPU is probed once, safely from any thread. */
+int cnet_lanes()
+{
+	pthread_once(&Hwonce, hwdetect);
+	return Hwlanes;
+}
+
+/* value words for n nodes of the given lane count, aligned for the vector units */
+uint64_t *cnet_walloc(const CNET *c, int lanes)
+{
+	size_t sz = ((size_t) c->n * lanes * sizeof(uint64_t) + 63) & ~(size_t) 63;
+	uint64_t *w = (uint64_t *) aligned_alloc(64, sz ? sz : 64);
+	memset(w, 0, sz);
+	return w;
+}
+
+/*-----------------------------------------------------------------------
+input: netlist, value words from cnet_walloc, lanes (1, 4 or 8)
+output: nothing
+called by: logic
+description: fault free simulation of 64*lanes patterns. Word k of
+  node i is w[i*lanes+k]; the PI words must already be set. Once
+  ccsim.c has loaded generated code for the netlist, that runs instead,
+  else the instruction tape of tape.c if there is one.
+author: Li
+-----------------------------------------------------------------------*/
+void cnet_wsim(const CNET *c, uint64_t *w, int lanes)
+{
+	int hw;
+	if(lanes < 9 && c->csim[lanes]){        /* generated code, ccsim.c */
+		c->csim[lanes](w);
+		return;
+	}
+	if(c->tape){
+		tape_wsim(c->tape, w, lanes);
+		return;
+	}
+	hw = cnet_lanes();
+	switch(lanes){
+		case 8:
+			if(hw >= 8) wsim8_avx512(c, (v8w *) w);
+			else wsim8(c, (v8w *) w);
+			break;
+		case 4:
+			if(hw >= 4) wsim4_avx2(c, (v4w *) w);
+			else wsim4(c, (v4w *) w);
+			break;
+		default:
+			wsim1(c, w);
+	}
+}
+
+/* one gate of the 64 bit word simulation, reading the fan-ins from w */
+uint64_t cnet_weval(const CNET *c, const uint64_t *w, int i)
+{
+	const int *p = c->fi + c->fioff[i];
+	const int *e = c->fi + c->fioff[i + 1];
+	uint64_t x;
+
+	if(p == e) return w[i];
+	x = w[*p++];
+	switch(c->type[i]){
+		case NOT: return ~x;
+		case XOR:
+			while(p < e) x ^= w[*p++];
+			return x;
+		case OR:
+		case NOR:
+			while(p < e) x |= w[*p++];
+			return c->type[i] == OR ? x : ~x;
+		case AND:
+		case NAND:
+			while(p < e) x &= w[*p++];
+			return c->type[i] == AND ? x : ~x;
+	}
+	return x;
+}
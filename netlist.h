@@ -0,0 +1,57 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*-----------------------------------------------------------------------
+  compiled netlist
+
+  Built once after READ from Node/Nodelev and never changed afterwards.
+  Node i of the compiled form is Nodelev[i], so the nodes are stored in
+  level order and fault k of FArr sits on node k/2. Fan-in and fan-out
+  are CSR index arrays: the fan-ins of node i are fi[fioff[i]] up to
+  fi[fioff[i+1]-1], and the same for fo/fooff. Every field is its own
+  column so a simulation pass only touches the arrays it needs.
+-----------------------------------------------------------------------*/
+typedef struct c_net {
+	int n;                  /* number of nodes */
+	int npi;                /* number of primary inputs */
+	int npo;                /* number of primary outputs */
+	int nlev;               /* number of levels (lev_max + 1) */
+	int nfi;                /* number of fan-in edges */
+	unsigned char *type;    /* gate type column (enum e_gtype) */
+	int *level;             /* level column */
+	int *num;               /* line number column */
+	int *fioff;             /* n+1 offsets into fi */
+	int *fi;                /* fan-in node indices */
+	int *fooff;             /* n+1 offsets into fo */
+	int *fo;                /* fan-out node indices */
+	int *pi;                /* primary inputs, same order as Pinput */
+	int *po;                /* primary outputs, same order as Poutput */
+	int *levoff;            /* nlev+1 offsets, level l is levoff[l]..levoff[l+1]-1 */
+	int *ord;               /* Node index of compiled node i */
+	unsigned char *val;     /* value column, 0 or 1 */
+	int *lnoff;             /* 2n+1 offsets into lrn per literal 2*i+b, or NULL */
+	int *lrn;               /* literals learned from "node i is b" (learn.c) */
+	int nlrn;
+	int *cc0, *cc1, *co;    /* SCOAP columns (scoap.c), or NULL */
+	struct tape *tape;      /* instruction tape (tape.c), or NULL */
+	void *dl;               /* generated simulation code (ccsim.c), or NULL */
+	void (*csim[9])(uint64_t *w);   /* its entry for 1, 4 and 8 lanes */
+	void *map;              /* circuit image the columns point into, or NULL */
+	size_t maplen;
+} CNET;
+
+/*----------------- new function        ----------------------------------*/
+extern CNET *cnet_new(int n, int nfi, int npi, int npo, int nlev);
+extern void cnet_free(CNET *c);
+extern void cnet_fanout(CNET *c);
+extern int cnet_eval(const CNET *c, const unsigned char *val, int i);
+extern void cnet_sim(const CNET *c, unsigned char *val);
+extern int cnet_lanes();
+extern uint64_t *cnet_walloc(const CNET *c, int lanes);
+extern void cnet_wsim(const CNET *c, uint64_t *w, int lanes);
+extern uint64_t cnet_weval(const CNET *c, const uint64_t *w, int i);
@@ -0,0 +1,175 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "type.h"
+#include "netlist.h"
+#include "evsim.h"
+#include "atpg.h"
+#include "scoap.h"
+#include "podem.h"
+
+void podem_init(struct podem *p, const CNET *c, long maxbt, double maxsec)
+{
+	atpg_init(&p->a, c);
+	p->cc0 = c->cc0;
+	p->cc1 = c->cc1;
+	p->dpi = (int *) malloc((c->npi + 1) * sizeof(int));
+	p->dval = (int *) malloc((c->npi + 1) * sizeof(int));
+	p->dmark = (int *) malloc((c->npi + 1) * sizeof(int));
+	p->dflip = (int *) malloc((c->npi + 1) * sizeof(int));
+	p->maxbt = maxbt;
+	p->maxsec = maxsec;
+}
+
+void podem_free(struct podem *p)
+{
+	atpg_free(&p->a);
+	free(p->dpi);
+	free(p->dval);
+	free(p->dmark);
+	free(p->dflip);
+}
+
+/* non-controlling value of a gate type, the value that lets a D through */
+static int ncval(int t)
+{
+	return t == AND || t == NAND ? 1 : 0;
+}
+
+/*-----------------------------------------------------------------------
+input: state, objective node and good value
+output: PI node, its value in *b
+called by: podem
+description: walk from the objective to a PI through X nodes. When one
+  input at the needed value sets the gate, take the input easiest to
+  set; when all inputs are needed, take the hardest first so a
+  conflict shows up early.
+author: Li
+-----------------------------------------------------------------------*/
+static int backtrace(struct podem *p, int n, int *b)
+{
+	const CNET *c = p->a.c;
+	const unsigned char *v = p->a.v;
+	int t, k, j, x, best, cost, want, all, par;
+
+	x = *b;
+	while(c->type[n] != IPT){
+		t = c->type[n];
+		if(t == NOT || t == NAND || t == NOR) x = !x;
+		best = -1;
+		cost = 0;
+		if(t == XOR){
+			/* any X input, with the parity of the known ones folded in */
+			for(par = 0, k = c->fioff[n]; k < c->fioff[n + 1]; k++){
+				j = c->fi[k];
+				if(v[j] != LX) par ^= L5G(v[j]);
+				else if(best < 0 || p->cc0[j] + p->cc1[j] < cost){
+					best = j;
+					cost = p->cc0[j] + p->cc1[j];
+				}
+			}
+			x ^= par;
+		}
+		else{
+			want = x;
+			all = t == BRCH || t == NOT || want == ncval(t);
+			for(k = c->fioff[n]; k < c->fioff[n + 1]; k++){
+				j = c->fi[k];
+				if(v[j] != LX) continue;
+				int cc = want ? p->cc1[j] : p->cc0[j];
+				if(best < 0 || (all ? cc > cost : cc < cost)){
+					best = j;
+					cost = cc;
+				}
+			}
+		}
+		if(best < 0) break;     /* cannot happen while n is X */
+		n = best;
+	}
+	*b = x;
+	return n;
+}
+
+/* next objective, 0 if there is none */
+static int objective(struct podem *p, int *n, int *b)
+{
+	struct atpg *a = &p->a;
+	const CNET *c = a->c;
+	int k, g, j, best = -1;
+
+	if(a->v[a->fnode] == LX){
+		*n = a->fnode;
+		*b = !a->fval;
+		return 1;
+	}
+	/* the D-frontier gate nearest a PO that still has an X path */
+	for(k = 0; k < a->ndfr; k++){
+		g = a->dfr[k];
+		if((best < 0 || c->level[g] > c->level[best]) && atpg_xpath(a, g)) best = g;
+	}
+	if(best < 0) return 0;
+	for(k = c->fioff[best]; k < c->fioff[best + 1]; k++){
+		j = c->fi[k];
+		if(a->v[j] == LX){
+			*n = j;
+			*b = ncval(c->type[best]);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/*-----------------------------------------------------------------------
+input: state, FArr fault id, room for a vector of npi values
+output: T_DETECTED with the test cube in vec (2 for X), T_REDUNDANT
+  once the decision tree is exhausted, or T_ABORTED at the backtrack or
+  time limit
+called by: podemS
+description: PODEM for one fault.
+author: Li
+-----------------------------------------------------------------------*/
+int podem(struct podem *p, int f, int *vec)
+{
+	struct atpg *a = &p->a;
+	clock_t start = clock();
+	int n, b, i;
+
+	atpg_fault(a, f);
+	p->nd = 0;
+	p->bt = 0;
+	for(;;){
+		if(a->ndpo){
+			atpg_vector(a, vec);
+			return T_DETECTED;
+		}
+		if(!atpg_conflict(a) && objective(p, &n, &b)){
+			i = backtrace(p, n, &b);
+			p->dpi[p->nd] = i;
+			p->dval[p->nd] = b;
+			p->dmark[p->nd] = a->ntrail;
+			p->dflip[p->nd++] = 0;
+			atpg_pi(a, i, b);
+			continue;
+		}
+		/* backtrack to the latest decision that still has a branch */
+		for(;;){
+			if(p->nd == 0) return T_REDUNDANT;
+			i = p->nd - 1;
+			atpg_undo(a, p->dmark[i]);
+			if(!p->dflip[i]) break;
+			p->nd--;
+		}
+		if(++p->bt > p->maxbt || (p->maxsec > 0
+			&& (double) (clock() - start) / CLOCKS_PER_SEC > p->maxsec))
+			return T_ABORTED;
+		p->dflip[i] = 1;
+		p->dval[i] = !p->dval[i];
+		atpg_pi(a, p->dpi[i], p->dval[i]);
+	}
+}
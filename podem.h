@@ -0,0 +1,28 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+/*-----------------------------------------------------------------------
+  PODEM test generation
+
+  Decisions are made on primary inputs only. An objective (activate the
+  fault, or set an X input of a D-frontier gate to its non-controlling
+  value) is backtraced to a PI through the easiest or hardest input by
+  SCOAP controllability, the PI value is implied on the atpg state and
+  a conflict backtracks by flipping the latest unflipped decision.
+-----------------------------------------------------------------------*/
+struct podem {
+	struct atpg a;
+	int *cc0, *cc1;         /* SCOAP controllability of the netlist */
+	int *dpi, *dval, *dmark, *dflip;   /* decision stack */
+	int nd;
+	long maxbt;             /* backtrack limit per fault */
+	double maxsec;          /* time limit per fault, 0 for none */
+	long bt;                /* backtracks of the last fault */
+};
+
+/*----------------- new function        ----------------------------------*/
+extern void podem_init(struct podem *p, const CNET *c, long maxbt, double maxsec);
+extern void podem_free(struct podem *p);
+extern int podem(struct podem *p, int f, int *vec);
@@ -0,0 +1,199 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "netlist.h"
+#include "pstore.h"
+#include "rpt.h"
+
+void ps_init(struct pstore *ps, int npi)
+{
+	memset(ps, 0, sizeof(*ps));
+	ps->npi = npi;
+	ps->nw = (npi + 63) / 64;
+}
+
+void ps_free(struct pstore *ps)
+{
+	free(ps->w);
+	free(ps->tgt);
+	memset(ps, 0, sizeof(*ps));
+}
+
+/* bits of word j that hold a PI */
+static uint64_t wmask(const struct pstore *ps, int j)
+{
+	if(j < ps->nw - 1 || ps->npi % 64 == 0) return ~0ULL;
+	return (1ULL << ps->npi % 64) - 1;
+}
+
+/* make room for one more vector, returns its index */
+static int grow(struct pstore *ps)
+{
+	if(ps->n == ps->cap){
+		ps->cap = ps->cap ? 2 * ps->cap : 64;
+		ps->w = (uint64_t *) realloc(ps->w, 2 * (size_t) ps->nw * ps->cap * sizeof(uint64_t));
+		ps->tgt = (int *) realloc(ps->tgt, ps->cap * sizeof(int));
+	}
+	return ps->n++;
+}
+
+/* cube of 0/1/2 (X) per PI into the two planes p */
+void ps_pack(const struct pstore *ps, const int *cube, uint64_t *p)
+{
+	int i;
+	memset(p, 0, 2 * ps->nw * sizeof(uint64_t));
+	for(i = 0; i < ps->npi; i++){
+		if(cube[i] == 2) continue;
+		p[ps->nw + (i >> 6)] |= 1ULL << (i & 63);
+		if(cube[i]) p[i >> 6] |= 1ULL << (i & 63);
+	}
+}
+
+/* append the packed cube p for fault tgt, returns its index */
+int ps_addp(struct pstore *ps, const uint64_t *p, int tgt)
+{
+	int k = grow(ps);
+	memcpy(PS_VAL(ps, k), p, 2 * ps->nw * sizeof(uint64_t));
+	ps->tgt[k] = tgt;
+	return k;
+}
+
+int ps_add(struct pstore *ps, const int *cube, int tgt)
+{
+	int k = grow(ps);
+	ps_pack(ps, cube, PS_VAL(ps, k));
+	ps->tgt[k] = tgt;
+	return k;
+}
+
+/* specify the X PIs of cube k from the packed cube p if no PI has
+   opposite values in the two, returns 1 if they were merged */
+int ps_merge(struct pstore *ps, int k, const uint64_t *p)
+{
+	uint64_t *v = PS_VAL(ps, k), *c = PS_CARE(ps, k);
+	const uint64_t *pv = p, *pc = p + ps->nw;
+	int j;
+	for(j = 0; j < ps->nw; j++)
+		if(c[j] & pc[j] & (v[j] ^ pv[j])) return 0;
+	for(j = 0; j < ps->nw; j++){
+		v[j] |= pv[j];
+		c[j] |= pc[j];
+	}
+	return 1;
+}
+
+/*-----------------------------------------------------------------------
+input: store, first vector to fill, enum e_xfill policy, seed for XF_RAND
+output: nothing
+called by: atpgrun
+description: give the X PIs of vectors from..n-1 a value. XF_0 and XF_1
+  use a constant, XF_RAND a random bit and XF_ADJ the value of the last
+  specified PI before it (the first specified one for leading X), which
+  keeps the number of 0/1 changes along the vector low.
+author: Li
+-----------------------------------------------------------------------*/
+void ps_xfill(struct pstore *ps, int from, int policy, uint64_t seed)
+{
+	struct rng r;
+	uint64_t *v, *c;
+	int k, j, i, last;
+
+	rng_seed(&r, seed);
+	for(k = from; k < ps->n; k++){
+		v = PS_VAL(ps, k);
+		c = PS_CARE(ps, k);
+		if(policy == XF_ADJ){
+			for(i = 0; i < ps->npi && !PS_BIT(c, i); i++);
+			last = i < ps->npi ? PS_BIT(v, i) : 0;
+			for(i = 0; i < ps->npi; i++){
+				if(PS_BIT(c, i)) last = PS_BIT(v, i);
+				else if(last) v[i >> 6] |= 1ULL << (i & 63);
+			}
+		}
+		for(j = 0; j < ps->nw; j++){
+			if(policy == XF_1) v[j] |= ~c[j] & wmask(ps, j);
+			else if(policy == XF_RAND) v[j] |= ~c[j] & rng_next(&r) & wmask(ps, j);
+			c[j] = wmask(ps, j);
+		}
+	}
+}
+
+/* transpose the 64x64 bit matrix a in place, bit c of a[r] goes to bit
+   r of a[c]; the off diagonal blocks are swapped at halving sizes */
+static void tr64(uint64_t *a)
+{
+	uint64_t m = 0x00000000ffffffffULL, t;
+	int j, k;
+	for(j = 32; j; j >>= 1, m ^= m << j)
+		for(k = 0; k < 64; k = (k + j + 1) & ~j){
+			t = (a[k] >> j ^ a[k + j]) & m;
+			a[k] ^= t << j;
+			a[k + j] ^= t;
+		}
+}
+
+/*-----------------------------------------------------------------------
+input: store, first vector, number of vectors (at most 64)
+output: piw[i] has the value of PI i in vector base+b at bit b, 0 for
+  b >= nb
+called by: ppsfp_load
+description: 64 PIs at a time, the value words of the vectors are put in
+  a 64x64 bit matrix and transposed.
+author: Li
+-----------------------------------------------------------------------*/
+void ps_transpose(const struct pstore *ps, int base, int nb, uint64_t *piw)
+{
+	uint64_t m[64];
+	int j, b, i, hi;
+	for(j = 0; j < ps->nw; j++){
+		for(b = 0; b < 64; b++) m[b] = b < nb ? PS_VAL(ps, base + b)[j] : 0;
+		tr64(m);
+		hi = ps->npi - 64 * j < 64 ? ps->npi - 64 * j : 64;
+		for(i = 0; i < hi; i++) piw[64 * j + i] = m[i];
+	}
+}
+
+/* turn the vector order around */
+void ps_reverse(struct pstore *ps)
+{
+	uint64_t *tmp = (uint64_t *) malloc((2 * ps->nw + 1) * sizeof(uint64_t));
+	size_t sz = 2 * ps->nw * sizeof(uint64_t);
+	int k, t;
+	for(k = 0; k < ps->n / 2; k++){
+		memcpy(tmp, PS_VAL(ps, k), sz);
+		memcpy(PS_VAL(ps, k), PS_VAL(ps, ps->n - 1 - k), sz);
+		memcpy(PS_VAL(ps, ps->n - 1 - k), tmp, sz);
+		t = ps->tgt[k];
+		ps->tgt[k] = ps->tgt[ps->n - 1 - k];
+		ps->tgt[ps->n - 1 - k] = t;
+	}
+	free(tmp);
+}
+
+/* drop the vectors with keep[k] == 0, the others keep their order;
+   returns the vectors left */
+int ps_keep(struct pstore *ps, const int *keep)
+{
+	int k, n = 0;
+	for(k = 0; k < ps->n; k++){
+		if(!keep[k]) continue;
+		if(n != k){
+			memcpy(PS_VAL(ps, n), PS_VAL(ps, k), 2 * ps->nw * sizeof(uint64_t));
+			ps->tgt[n] = ps->tgt[k];
+		}
+		n++;
+	}
+	return ps->n = n;
+}
+
+/* memory held by the store */
+size_t ps_bytes(const struct pstore *ps)
+{
+	return (size_t) ps->cap * (2 * ps->nw * sizeof(uint64_t) + sizeof(int));
+}
@@ -0,0 +1,41 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+/*-----------------------------------------------------------------------
+  pattern store
+
+  Test vectors and test cubes, two bits per PI in one contiguous block:
+  vector k is nw words of values followed by nw words of care bits, PI i
+  in bit i%64 of word i/64. A PI whose care bit is 0 is X and has value
+  bit 0. tgt[k] is the FArr fault vector k was made for. The bit-parallel
+  simulators take 64 vectors at a time through ps_transpose, one word
+  per PI with vector base+b in bit b.
+-----------------------------------------------------------------------*/
+enum e_xfill {XF_0, XF_1, XF_RAND, XF_ADJ};
+
+struct pstore {
+	int npi;
+	int nw;                 /* words of one plane, (npi+63)/64 */
+	int n, cap;             /* vectors held, room for */
+	uint64_t *w;            /* the planes */
+	int *tgt;
+};
+
+#define PS_VAL(ps, k) ((ps)->w + 2 * (size_t) (ps)->nw * (k))
+#define PS_CARE(ps, k) (PS_VAL(ps, k) + (ps)->nw)
+#define PS_BIT(p, i) ((p)[(i) >> 6] >> ((i) & 63) & 1)
+
+/*----------------- new function        ----------------------------------*/
+extern void ps_init(struct pstore *ps, int npi);
+extern void ps_free(struct pstore *ps);
+extern void ps_pack(const struct pstore *ps, const int *cube, uint64_t *p);
+extern int ps_addp(struct pstore *ps, const uint64_t *p, int tgt);
+extern int ps_add(struct pstore *ps, const int *cube, int tgt);
+extern int ps_merge(struct pstore *ps, int k, const uint64_t *p);
+extern void ps_xfill(struct pstore *ps, int from, int policy, uint64_t seed);
+extern void ps_transpose(const struct pstore *ps, int base, int nb, uint64_t *piw);
+extern void ps_reverse(struct pstore *ps);
+extern int ps_keep(struct pstore *ps, const int *keep);
+extern size_t ps_bytes(const struct pstore *ps);
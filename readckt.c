@@ -56,8 +56,35 @@ lev()
 #include <ctype.h>
 #include <stdlib.h>
 #include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
 #include "type.h"
 #include "prigate.h"
+#include "netlist.h"
+#include "ckb.h"
+#include "evsim.h"
+#include "pstore.h"
+#include "fsim.h"
+#include "cfsim.h"
+#include "tsim.h"
+#include "atpg.h"
+#include "podem.h"
+#include "dalg.h"
+#include "fan.h"
+#include "sat.h"
+#include "satpg.h"
+#include "rpt.h"
+#include "fcoll.h"
+#include "learn.h"
+#include "scoap.h"
+#include "lsim.h"
+#include "ccsim.h"
+#include "tape.h"
 
 #define MAXLINE 81               /* Input buffer size */
 #define MAXNAME 31               /* File name size */
@@ -65,10 +92,9 @@ lev()
 #define Upcase(x) ((isalpha(x) && islower(x))? toupper(x) : (x))
 #define Lowcase(x) ((isalpha(x) && isupper(x))? tolower(x) : (x))
 
-enum e_com {READ, PC, HELP, QUIT, LEV, LOGIC, DFS ,PFS,DAL,PODEM};
+enum e_com {READ, PC, HELP, QUIT, LEV, LOGIC, DFS ,PFS,PPSFP,CFS,THREADS,DAL,PODEM,FAN,SAT,COMPACT,SCOAP,COMPILE,TAPE};
 enum e_state {EXEC, CKTLD};         /* Gstate values */
 enum e_ntype {GATE, PI, FB, PO};    /* column 1 of circuit format */
-enum e_gtype {IPT, BRCH, XOR, OR, NOR, NOT, NAND, AND};  /* gate types */
 
 struct cmdstruc {
    char name[MAXNAME];        /* command syntax */
@@ -85,25 +111,28 @@ typedef struct n_struc {
    struct n_struc **unodes;   /* pointer to array of up nodes */
    struct n_struc **dnodes;   /* pointer to array of down nodes */
    int level;                 /* LI:level of the gate output */
-   int val;				  /* Li: vaule of line -1 is unkown */
-   struct fList *head;    /* li: for DFS */ 
    unsigned sa1;
    unsigned sa0;
-   int pval;
 
 } NSTRUC;                     
 
 /*----------------- new function        ----------------------------------*/
-int calval(int type,int i, int j);
-int getlev(NSTRUC *np);
 void initFArr();
-void setNodelev();
-void setinput(); /* load input into line node */
-void levsim();
-
-
-#define NUMFUNCS 10
-int cread(), pc(), help(), quit(), lev(), logic(), DFS_client(),PFS_client(),D_client(),podemS();
+void setFArr();
+void compile(); /* build Cnet from Nodelev */
+int loadimage(); /* rebuild the circuit from a .ckb image */
+int setdnodes(); /* fill Node.dnodes from Node.unodes */
+struct fList* addfList(struct fList* tail,struct fault *fp);
+void freeflist(struct fList **head); /* free a fault list */
+void atpgopts(char *cp, long *maxbt, double *maxsec);
+void atpgrun(int (*gen)(void *, int, int *), void *s, const long *bt,
+	const char *okname, const char *badname); /* ATPG over Fchead */
+int podemgen(void *s, int f, int *vec), dalgen(void *s, int f, int *vec), fangen(void *s, int f, int *vec);
+int satgen(void *s, int f, int *vec);
+
+
+#define NUMFUNCS 19
+int cread(), pc(), help(), quit(), lev(), logic(), DFS_client(),PFS_client(),PPSFP_client(),CFS_client(),threads(),D_client(),podemS(),fanS(),satS(),compact(),scoapS(),ccompile(),tapeS();
 struct cmdstruc command[NUMFUNCS] = {
    {"READ", cread, EXEC},
    {"PC", pc, CKTLD},
@@ -113,8 +142,17 @@ struct cmdstruc command[NUMFUNCS] = {
    {"LOGIC",logic,CKTLD},
    {"DFS",DFS_client,CKTLD},
    {"PFS",PFS_client,CKTLD},
+   {"PPSFP",PPSFP_client,CKTLD},
+   {"CFS",CFS_client,CKTLD},
+   {"THREADS",threads,EXEC},
    {"DAL",D_client,CKTLD},
    {"PODEM",podemS,CKTLD},
+   {"FAN",fanS,CKTLD},
+   {"SAT",satS,CKTLD},
+   {"COMPACT",compact,CKTLD},
+   {"SCOAP",scoapS,CKTLD},
+   {"COMPILE",ccompile,CKTLD},
+   {"TAPE",tapeS,EXEC},
 };
 
 /*------------------------------------------------------------------------*/
@@ -125,6 +163,8 @@ NSTRUC **Poutput;               /* pointer to array of primary outputs */
 int Nnodes;                     /* number of nodes */
 int Npi;                        /* number of primary inputs */
 int Npo;                        /* number of primary outputs */
+NSTRUC **Upool;                 /* storage of all unodes arrays */
+NSTRUC **Dpool;                 /* storage of all dnodes arrays */
 int Done = 0;                   /* status bit to terminate program */
 
 
@@ -132,17 +172,23 @@ int Done = 0;                   /* status bit to terminate program */
 /*------------------------LI:new variable ----------------------...----------*/
 int Nbr; 						/* numer of branch */
 int lev_max = 0;                /* max level in circuit */
-int *input;                     /* input */
+int *Levoff;                    /* level l is Nodelev[Levoff[l]..Levoff[l+1]-1] */
 NSTRUC **Nodelev;               /* pointer to array of gates sorted by level */
+CNET *Cnet;                     /* compiled netlist, node i is Nodelev[i] */
+int Nthreads = 1;               /* fault simulation workers */
+int Dcompact = 0;               /* ATPG merges compatible test cubes */
+int Xfill = XF_0;               /* how the X of the test cubes are filled */
+double Rgain = 0;               /* random phase: least % of faults per block, 0 for none */
+unsigned long long Rseed = 1;   /* seed of the random phase */
+int Usetape = 1;                /* READ builds the instruction tape */
 //NSTRUC **Pbrput;				/* pointer to array of branch*/
 struct fList *Fchead;	/*collasped list*/
 struct fault *FArr; /*original Farr*/
-struct fault **Fcp;
 
 int snum = 0;
-struct ipList *siphead = NULL;
+struct pstore Ptest;            /* test vectors, npi 0 before any ATPG run */
 int fnum = 0;
-struct ipList *fiphead = NULL;
+struct fList *fiphead = NULL;   /* faults without a test */
 
 int psnum = 0;
 int pfnum = 0;
@@ -191,115 +237,363 @@ main()
    }
 }
 
+/*-----------------------------------------------------------------------
+  loader scratch for cread. Everything is learned in one pass over the
+  mapped file; fan-ins are kept as line numbers and only resolved through
+  tbl once the whole file has been seen, so forward references are fine.
+-----------------------------------------------------------------------*/
+struct rdckt {
+   const char *fname;         /* file name for error messages */
+   const char *p, *end;       /* scan position and end of the mapping */
+   const char *ls;            /* start of the current line */
+   int line;                  /* current line number, from 1 */
+   int n, ncap;               /* records seen / allocated */
+   int *tp, *num, *type, *fin, *foff, *lno;
+   int ne, ecap;              /* fan-in entries seen / allocated */
+   int *ein, *ecol;           /* fan-in line number and its column */
+   int ntbl;                  /* size of tbl */
+   int *tbl;                  /* line number -> record, -1 if unused */
+};
+
+#define GROW(p, cap) \
+   ((p) = realloc((p), (size_t)(cap) * sizeof(*(p))))
+
+/* print a loader error at the current scan position */
+void rderr(struct rdckt *rd, const char *msg, int arg)
+{
+   printf("%s:%d:%d: ", rd->fname, rd->line, (int)(rd->p - rd->ls) + 1);
+   printf(msg, arg);
+   printf("\n");
+}
+
+/* skip blanks inside a line, return the next character or '\n' at the end */
+int rdskip(struct rdckt *rd)
+{
+   while(rd->p < rd->end && (*rd->p == ' ' || *rd->p == '\t' || *rd->p == '\r'))
+      rd->p++;
+   return rd->p < rd->end ? *rd->p : '\n';
+}
+
+/* scan one non-negative decimal integer on the current line */
+int rdint(struct rdckt *rd, int *v, const char *what)
+{
+   long x = 0;
+   int c = rdskip(rd);
+
+   if(c < '0' || c > '9') {
+      rderr(rd, c == '\n' ? "line ends, expected %s" : "expected %s", 0);
+      return 0;
+   }
+   while(rd->p < rd->end && *rd->p >= '0' && *rd->p <= '9') {
+      x = x * 10 + (*rd->p++ - '0');
+      if(x > 0x7fffffff) {
+         rderr(rd, "number too large", 0);
+         return 0;
+      }
+   }
+   *v = (int) x;
+   return 1;
+}
+
+/* parse the mapped file into rd, return 0 on the first error */
+int rdparse(struct rdckt *rd)
+{
+   int tp, nd, i, k, f;
+
+   while(rd->p < rd->end) {
+      rd->ls = rd->p;
+      rd->line++;
+      if(rdskip(rd) == '\n') {             /* empty line */
+         if(rd->p < rd->end) rd->p++;
+         continue;
+      }
+      if(rd->n == rd->ncap) {
+         rd->ncap = rd->ncap ? 2 * rd->ncap : 1024;
+         GROW(rd->tp, rd->ncap); GROW(rd->num, rd->ncap);
+         GROW(rd->type, rd->ncap); GROW(rd->fin, rd->ncap);
+         GROW(rd->foff, rd->ncap + 1); GROW(rd->lno, rd->ncap);
+      }
+      k = rd->n;
+      if(!rdint(rd, &tp, "node type") || !rdint(rd, &nd, "line number")) return 0;
+      rd->tp[k] = tp;
+      rd->num[k] = nd;
+      rd->lno[k] = rd->line;
+      switch(tp) {
+         case PI:
+         case PO:
+         case GATE:
+            if(!rdint(rd, &rd->type[k], "gate type") || !rdint(rd, &f, "fanout count")
+               || !rdint(rd, &rd->fin[k], "fanin count")) return 0;
+            break;
+         case FB:
+            rd->fin[k] = 1;
+            if(!rdint(rd, &rd->type[k], "gate type")) return 0;
+            break;
+         default:
+            rd->p = rd->ls;
+            rderr(rd, "unknown node type %d", tp);
+            return 0;
+      }
+      if(rd->type[k] > AND) {
+         rderr(rd, "unknown gate type %d", rd->type[k]);
+         return 0;
+      }
+      /* line number -> record, grown on demand */
+      if(nd >= rd->ntbl) {
+         i = rd->ntbl;
+         rd->ntbl = nd + 1 > 2 * i ? nd + 1 : 2 * i;
+         GROW(rd->tbl, rd->ntbl);
+         for(; i < rd->ntbl; i++) rd->tbl[i] = -1;
+      }
+      if(rd->tbl[nd] >= 0) {
+         rderr(rd, "line %d defined twice", nd);
+         return 0;
+      }
+      rd->tbl[nd] = k;
+      rd->foff[k] = rd->ne;
+      for(i = 0; i < rd->fin[k]; i++) {
+         if(rd->ne == rd->ecap) {
+            rd->ecap = rd->ecap ? 2 * rd->ecap : 4096;
+            GROW(rd->ein, rd->ecap); GROW(rd->ecol, rd->ecap);
+         }
+         rdskip(rd);
+         rd->ecol[rd->ne] = (int)(rd->p - rd->ls) + 1;
+         if(!rdint(rd, &rd->ein[rd->ne], "fanin line")) return 0;
+         rd->ne++;
+      }
+      if(rdskip(rd) != '\n') {
+         rderr(rd, "extra data after %d fanins", rd->fin[k]);
+         return 0;
+      }
+      if(rd->p < rd->end) rd->p++;
+      rd->n++;
+   }
+   if(rd->n == 0) {
+      printf("%s: no nodes\n", rd->fname);
+      return 0;
+   }
+   rd->foff[rd->n] = rd->ne;
+   /* resolve fan-in line numbers into record indices */
+   for(k = 0; k < rd->n; k++)
+      for(i = rd->foff[k]; i < rd->foff[k + 1]; i++) {
+         nd = rd->ein[i];
+         if(nd >= rd->ntbl || rd->tbl[nd] < 0) {
+            printf("%s:%d:%d: line %d is never defined\n", rd->fname, rd->lno[k], rd->ecol[i], nd);
+            return 0;
+         }
+         rd->ein[i] = rd->tbl[nd];
+      }
+   return 1;
+}
+
+void rdfree(struct rdckt *rd)
+{
+   free(rd->tp); free(rd->num); free(rd->type); free(rd->fin);
+   free(rd->foff); free(rd->lno); free(rd->ein); free(rd->ecol);
+   free(rd->tbl);
+}
+
 /*-----------------------------------------------------------------------
 input: circuit description file name
 output: nothing
 called by: main
 description:
   This routine reads in the circuit description file and set up all the
-  required data structure. It first checks if the file exists, then it
-  sets up a mapping table, determines the number of nodes, PI's and PO's,
-  allocates dynamic data arrays, and fills in the structural information
-  of the circuit. In the ISCAS circuit description format, only upstream
-  nodes are specified. Downstream nodes are implied. However, to facilitate
-  forward implication, they are also built up in the data structure.
-  To have the maximal flexibility, three passes through the circuit file
-  are required: the first pass to determine the size of the mapping table
-  , the second to fill in the mapping table, and the third to actually
-  set up the circuit information. These procedures may be simplified in
-  the future.
+  required data structure. If a precompiled image (c17.ckt -> c17.ckb)
+  stamped with the current size and mtime of the file exists, it is
+  mapped by ckb_load and the data structures are rebuilt from it by
+  loadimage, with no parsing, levelization, fault collapsing, static
+  learning or SCOAP.
+  Otherwise the file is mapped into memory and parsed in a single pass
+  by rdparse, which has no line length limit and keeps fan-ins as line
+  numbers until the end, when they are resolved through a mapping table
+  that grows with the largest line number seen. A bad file is reported
+  with its line and column and leaves the previously loaded circuit
+  untouched. In the ISCAS circuit description format, only upstream
+  nodes are specified. Downstream nodes are implied. However, to
+  facilitate forward implication, they are also built up in the data
+  structure. The unodes/dnodes arrays of all nodes share two pools. After
+  a text read the image is written for the next READ.
 -----------------------------------------------------------------------*/
 cread(cp)
 char *cp;
 {
-   char buf[MAXLINE];
-   int ntbl, *tbl, i, j, k, nd, tp, fo, fi, ni = 0, no = 0;
-   int nb = 0;
-   FILE *fd;
+   char buf[MAXLINE], cname[MAXLINE + 8];
+   int i, j, k, fd, ni = 0, no = 0;
+   struct stat st;
+   struct rdckt rd;
+   struct ckb img;
+   struct fList *br;
+   char *map;
    NSTRUC *np;
 
    sscanf(cp, "%s", buf);
-   if((fd = fopen(buf,"r")) == NULL) {
+   if((fd = open(buf, O_RDONLY)) < 0) {
       printf("File %s does not exist!\n", buf);
       return;
    }
-   if(Gstate >= CKTLD) clear();
-   Nnodes = Npi = Npo = ntbl = 0;
-   Nbr = 0; /* Nbr reset */
-   while(fgets(buf, MAXLINE, fd) != NULL) {
-      if(sscanf(buf,"%d %d", &tp, &nd) == 2) {
-         if(ntbl < nd) ntbl = nd;
-         Nnodes ++;
-         if(tp == PI) Npi++;
-         else if(tp == PO) Npo++;
-		 else if(tp == FB) Nbr++;  /*Li:branch array count*/
-      }
+   fstat(fd, &st);
+   ckb_name(buf, cname, sizeof(cname));
+   if(ckb_load(cname, &st, &img)) {
+      close(fd);
+      if(Gstate >= CKTLD) clear();
+      loadimage(&img);
+      printf("======> circuit image %s loaded\n", cname);
+      goto done;
+   }
+
+   map = st.st_size ? mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0) : NULL;
+   close(fd);
+   if(map == MAP_FAILED) {
+      printf("File %s can not be mapped!\n", buf);
+      return 0;
+   }
+   memset(&rd, 0, sizeof(rd));
+   rd.fname = buf;
+   rd.p = map;
+   rd.end = map + st.st_size;
+   madvise(map, st.st_size, MADV_SEQUENTIAL);
+   i = rdparse(&rd);
+   if(map) munmap(map, st.st_size);
+   if(!i) {
+      rdfree(&rd);
+      return 0;
    }
-   tbl = (int *) malloc(++ntbl * sizeof(int));
 
-   fseek(fd, 0L, 0);
-   i = 0;
-   while(fgets(buf, MAXLINE, fd) != NULL) {
-      if(sscanf(buf,"%d %d", &tp, &nd) == 2) tbl[nd] = i++;
+   if(Gstate >= CKTLD) clear();
+   Nnodes = rd.n;
+   Npi = Npo = Nbr = 0;
+   for(i = 0; i < Nnodes; i++) {
+      if(rd.tp[i] == PI) Npi++;
+      else if(rd.tp[i] == PO) Npo++;
+      else if(rd.tp[i] == FB) Nbr++;  /*Li:branch array count*/
    }
    allocate();
+   Upool = (NSTRUC **) malloc((rd.ne + 1) * sizeof(NSTRUC *));
+   Dpool = (NSTRUC **) malloc((rd.ne + 1) * sizeof(NSTRUC *));
+   for(i = 0; i < Nnodes; i++) {
+      np = &Node[i];
+      np->num = rd.num[i];
+      np->type = rd.type[i];
+      np->fin = rd.fin[i];
+      np->level = -1; /* Li init */
+      np->unodes = Upool + rd.foff[i];
+      for(j = 0; j < np->fin; j++) {
+         np->unodes[j] = &Node[rd.ein[rd.foff[i] + j]];
+         np->unodes[j]->fout++;
+      }
+      if(rd.tp[i] == PI) Pinput[ni++] = np;
+      else if(rd.tp[i] == PO) Poutput[no++] = np;
+   }
+   setdnodes();
+   rdfree(&rd);
 
-   fseek(fd, 0L, 0);
-   while(fscanf(fd, "%d %d", &tp, &nd) != EOF) {
-      np = &Node[tbl[nd]];
-      np->num = nd;
-      /* Li init */
-	  np->level = -1; 
-      np->val = 0;
-	  np->pval = 0;
-      np->head = (struct fList *)malloc(sizeof(struct fList));
-	  np->head->fp = NULL; 
-	  np->head->next = NULL;
-      /* Li init */
-      if(tp == PI) Pinput[ni++] = np;
-      else if(tp == PO) Poutput[no++] = np;
-	  //else if(tp == FB) Pbrput[nb++] = np; /*Li: add branh*/
+   if(!lev()) {
+      clear();
+      return 0;
+   }
+   compile(); /* L: compiled netlist for the simulators */
+   scoap(Cnet); /* L: testability, kept with the netlist */
+   initFArr(); /* L:get original fault list */
+   printf("Learned implications = %d\n", learn(Cnet));
+
+   /* L: save the image for the next READ of this file */
+   img.c = Cnet;
+   img.nbr = Nbr;
+   for(img.nfc = 0, br = Fchead->next; br; br = br->next) img.nfc++;
+   img.fc = (int *) malloc((img.nfc + 1) * sizeof(int));
+   for(k = 0, br = Fchead->next; br; br = br->next) img.fc[k++] = br->fp - FArr;
+   ckb_save(cname, &st, &img);
+   free(img.fc);
+
+done:
+   if(Usetape) Cnet->tape = tape_build(Cnet); /* L: flat instruction list for cnet_sim and cnet_wsim */
+   Gstate = CKTLD;
+   printf("==> OK\n");
+}
 
-      switch(tp) {
-         case PI:
-         case PO:
-         case GATE:
-            fscanf(fd, "%d %d %d", &np->type, &np->fout, &np->fin);
-            break;
-         
-         case FB:
-            np->fout = np->fin = 1;
-            fscanf(fd, "%d", &np->type);
-            break;
+/*-----------------------------------------------------------------------
+input: nothing
+output: nothing
+called by: cread, loadimage
+description: fan-out counts are already in Node.fout; carve the dnodes
+  arrays out of Dpool and fill them in Node order.
+-----------------------------------------------------------------------*/
+setdnodes()
+{
+   int i, j, k;
+   NSTRUC *np;
 
-         default:
-            printf("Unknown node type!\n");
-            exit(-1);
-         }
-      np->unodes = (NSTRUC **) malloc(np->fin * sizeof(NSTRUC *));
-      np->dnodes = (NSTRUC **) malloc(np->fout * sizeof(NSTRUC *));
-      for(i = 0; i < np->fin; i++) {
-         fscanf(fd, "%d", &nd);
-         np->unodes[i] = &Node[tbl[nd]];
-         }
-      for(i = 0; i < np->fout; np->dnodes[i++] = NULL);
-      }
-   	
-   for(i = 0; i < Nnodes; i++) {
+   for(i = k = 0; i < Nnodes; i++) {
+      Node[i].dnodes = Dpool + k;
+      k += Node[i].fout;
+      Node[i].fout = 0;
+   }
+   for(i = 0; i < Nnodes; i++)
       for(j = 0; j < Node[i].fin; j++) {
          np = Node[i].unodes[j];
-         k = 0;
-         while(np->dnodes[k] != NULL) k++;
-         np->dnodes[k] = &Node[i];
-         }
+         np->dnodes[np->fout++] = &Node[i];
       }
+}
 
-   input = (int *) malloc(ni * sizeof(int)); /* LI */
-   for(i = 0;i<Npi;i++) input[i] = 0; /* LI : inaite the input */
-   initFArr(); /* L:get original fault list */
-   fclose(fd);
-   Gstate = CKTLD;
-   printf("==> OK\n");
+/*-----------------------------------------------------------------------
+input: circuit image
+output: nothing
+called by: cread
+description: rebuild Node, Pinput, Poutput, Nodelev, FArr and the
+  collapsed list Fchead from a circuit image. The image becomes Cnet.
+-----------------------------------------------------------------------*/
+loadimage(k)
+struct ckb *k;
+{
+   int i, j, f;
+   NSTRUC *np;
+   struct fList *br;
+
+   Cnet = k->c;
+   Nnodes = Cnet->n;
+   Npi = Cnet->npi;
+   Npo = Cnet->npo;
+   Nbr = k->nbr;
+   lev_max = Cnet->nlev - 1;
+   allocate();
+   Upool = (NSTRUC **) malloc((Cnet->nfi + 1) * sizeof(NSTRUC *));
+   Dpool = (NSTRUC **) malloc((Cnet->nfi + 1) * sizeof(NSTRUC *));
+   Nodelev = (NSTRUC **) malloc(Nnodes * sizeof(NSTRUC *));
+   Levoff = (int *) malloc((lev_max + 2) * sizeof(int));
+   for(i = 0; i <= lev_max + 1; i++) Levoff[i] = Cnet->levoff[i];
+   for(i = 0; i < Nnodes; i++) {
+      np = &Node[Cnet->ord[i]];
+      Nodelev[i] = np;
+      np->num = Cnet->num[i];
+      np->type = Cnet->type[i];
+      np->level = Cnet->level[i];
+      np->fin = Cnet->fioff[i + 1] - Cnet->fioff[i];
+   }
+   /* unodes in Node order, like a text read */
+   for(i = j = 0; i < Nnodes; i++) {
+      Node[i].unodes = Upool + j;
+      j += Node[i].fin;
+   }
+   for(i = 0; i < Nnodes; i++) {
+      np = Nodelev[i];
+      for(j = 0; j < np->fin; j++) {
+         np->unodes[j] = Nodelev[Cnet->fi[Cnet->fioff[i] + j]];
+         np->unodes[j]->fout++;
+      }
+   }
+   setdnodes();
+   for(i = 0; i < Npi; i++) Pinput[i] = Nodelev[Cnet->pi[i]];
+   for(i = 0; i < Npo; i++) Poutput[i] = Nodelev[Cnet->po[i]];
+   setFArr();
+   br = Fchead;
+   for(i = 0; i < k->nfc; i++) {
+      f = k->fc[i];
+      br->next = (struct fList *) malloc(sizeof(struct fList));
+      br = br->next;
+      br->fp = &FArr[f];
+   }
+   br->next = NULL;
 }
 
 /*-----------------------------------------------------------------------
@@ -338,11 +632,6 @@ char *cp;
    printf("Number of primary outputs = %d\n", Npo);
    /* L the folloing code print the collapse fault list */
    /*
-    printf("Nbr = %d\n",Nbr);
-    for(i=0;i<2*(Npi+Nbr);i++){
-		printf("line = %d ; type = %d; lev = %d\n",Fcp[i]->fnum,Fcp[i]->fval, Fcp[i]->Np->level);
-	}//show orginal fault list
-	printf("colla\n");
 	struct fList * br = Fchead->next;
 	while(br){
 		printf("line = %d ; type = %d; lev = %d\n", br->fp->fnum,br->fp->fval, br->fp->Np->level);
@@ -367,6 +656,35 @@ help()
    printf("print this help information\n");
    printf("LEV - ");
    printf("levelize the circuit\n");
+   printf("LOGIC [64|256|512] [-n count|all] [-f first] [-g] [-p file] [-b] [-o file] - ");
+   printf("bit-parallel logic simulation into output.txt\n");
+   printf("  (-g counts in Gray code, -p replays a pattern file, -b writes binary)\n");
+   printf("PPSFP - ");
+   printf("grade the DAL vectors with fault dropping\n");
+   printf("CFS - ");
+   printf("grade the DAL vectors by concurrent fault simulation\n");
+   printf("THREADS [n] - ");
+   printf("worker threads for DFS, PFS and PPSFP (0: one per CPU)\n");
+   printf("DAL [-b backtracks] [-t seconds] - ");
+   printf("generate tests with the D-algorithm into Dal.txt\n");
+   printf("PODEM [-b backtracks] [-t seconds] - ");
+   printf("generate tests for the collapsed faults\n");
+   printf("FAN [-b backtracks] [-t seconds] - ");
+   printf("generate tests with FAN, deciding on headlines\n");
+   printf("SAT [-b conflicts] [-t seconds] - ");
+   printf("generate tests with the built-in SAT solver\n");
+   printf("  (DAL, PODEM, FAN and SAT also take -r gain [-s seed]: random\n");
+   printf("  patterns first, while a block of 64 detects gain %% of the faults)\n");
+   printf("  (and -c: merge compatible test cubes before filling the X PIs)\n");
+   printf("  (and -x 0|1|r|a: fill the X PIs with 0, 1, random or adjacent values)\n");
+   printf("COMPACT - ");
+   printf("drop the vectors reverse order fault simulation finds useless\n");
+   printf("SCOAP [n] - ");
+   printf("testability summary and the n (10) hardest faults\n");
+   printf("COMPILE [compiler] - ");
+   printf("build the circuit into native simulation code for LOGIC and PPSFP\n");
+   printf("TAPE [on|off] - ");
+   printf("simulate from the instruction tape or walk the netlist\n");
    printf("QUIT - ");
    printf("stop and exit\n");
 }
@@ -391,28 +709,34 @@ output: nothing
 called by: cread
 description:
   This routine clears the memory space occupied by the previous circuit
-  before reading in new one. It frees up the dynamic arrays Node.unodes,
-  Node.dnodes, Node.flist, Node, Pinput, Poutput, and Tap.
+  before reading in new one. It frees up the dynamic arrays Upool,
+  Dpool (Node.unodes and Node.dnodes), Node, Pinput, Poutput, and Tap.
 
 -----------------------------------------------------------------------*/
 clear()
 {
-   int i;
-
-   for(i = 0; i<Nnodes; i++) {
-      free(Node[i].unodes);
-      free(Node[i].dnodes);
-	  free(Node[i].head);
-   }
+   free(Upool);
+   free(Dpool);
    free(Node);
    free(Pinput);
    free(Poutput);
+   Upool = Dpool = Pinput = Poutput = NULL;
+   Node = NULL;
    /* Li  free memory*/
    //free(Pbrput);
-   free(Fcp);
    free(Nodelev);
+   free(Levoff);
+   Nodelev = NULL;
+   Levoff = NULL;
    free(FArr);
    free(Fchead);
+   FArr = NULL;
+   Fchead = NULL;
+   ps_free(&Ptest);
+   freeflist(&fiphead);
+   snum = fnum = 0;
+   cnet_free(Cnet);
+   Cnet = NULL;
    /* Li  end*/
    Gstate = EXEC;
 }
@@ -434,7 +758,6 @@ allocate()
    Node = (NSTRUC *) malloc(Nnodes * sizeof(NSTRUC));\
    Fchead = (struct fList*) malloc(sizeof(struct fList));
    FArr = (struct fault *) malloc(2 * Nnodes * sizeof(struct fault)); /*LI: fault */
-   Fcp = (struct fault **) malloc(2 * (Nbr + Npi) * sizeof(struct fault *)); 
    //Pbrput = (NSTRUC **) malloc(Nbr * sizeof(NSTRUC *));
    Pinput = (NSTRUC **) malloc(Npi * sizeof(NSTRUC *));
    Poutput = (NSTRUC **) malloc(Npo * sizeof(NSTRUC *));
@@ -468,260 +791,171 @@ int tp;
 }
 /*-----------------------------------------------------------------------
 input: None
-output: level
-called by: user
+output: 1 on success, 0 if the circuit has a combinational loop
+called by: cread, user
 description:functions achieve leveliziation 
+  Kahn style topological sort over the dnodes lists, O(nodes + edges)
+  and without recursion. A node is ready once all its fan-ins have been
+  levelized; its level is one more than its deepest fan-in, and PIs are
+  level 0. Nodes that are never ready sit on a loop. Nodelev is then
+  filled by a counting sort on the level, keeping Node order inside a
+  level, and Levoff[l]..Levoff[l+1]-1 are the Nodelev positions of
+  level l.
 author: Li
 -----------------------------------------------------------------------*/
-
-int getlev(NSTRUC *np){
-	if(np->type == 0){
-		np->level = 0;
-		return 0;
+int lev() /* set the gate level, Nodelev and Levoff */
+{
+	int i,j,head,tail;
+	int *cnt = (int *) malloc(Nnodes * sizeof(int)); /* fan-ins not yet levelized */
+	NSTRUC **q = (NSTRUC **) malloc(Nnodes * sizeof(NSTRUC *));
+	NSTRUC *np, *nd;
+
+	free(Nodelev);
+	free(Levoff);
+	lev_max = 0;
+	head = tail = 0;
+	for(i = 0; i<Nnodes; i++){
+		Node[i].level = 0;
+		cnt[i] = Node[i].fin;
+		if(cnt[i] == 0) q[tail++] = &Node[i];
 	}
-	if(np->level != -1)
-		return np->level;
-	int lev[np->fin];
-	int max;
-	int i;
-	for(i = 0;i<np->fin;i++){
-		lev[i]=getlev(np->unodes[i]);
+	while(head < tail){
+		np = q[head++];
+		if(np->level > lev_max) lev_max = np->level;
+		for(j = 0; j<np->fout; j++){
+			nd = np->dnodes[j];
+			if(nd->level < np->level + 1) nd->level = np->level + 1;
+			if(--cnt[nd->indx] == 0) q[tail++] = nd;
+		}
 	}
-	max = lev[0];
-	for(i = 0;i<np->fin;i++){
-		if(lev[i]>max)
-			max = lev[i];
+	if(tail < Nnodes){
+		printf("combinational loop through line");
+		for(i = j = 0; i<Nnodes && j<10; i++)
+			if(cnt[i]){ printf(" %d",Node[i].num); j++; }
+		printf("%s\n", tail + j < Nnodes ? " ..." : "");
+		free(cnt);
+		free(q);
+		Nodelev = NULL;
+		Levoff = NULL;
+		return 0;
 	}
-	np->level = max + 1;
-	return max+1;
-}
-
-
-
-lev() /* set the gate level and Nodelev() */
-{
-	int i;
-	for(i = 0; i<Npo; i++){
-    	getlev(Poutput[i]);
-		if(lev_max<Poutput[i]->level)
-			lev_max = Poutput[i]->level;
-   	} 
-   setNodelev();
+	/* counting sort by level */
+	Levoff = (int *) calloc(lev_max + 2, sizeof(int));
+	for(i = 0; i<Nnodes; i++) Levoff[Node[i].level + 1]++;
+	for(i = 0; i<=lev_max; i++) Levoff[i+1] += Levoff[i];
+	for(i = 0; i<=lev_max; i++) cnt[i] = Levoff[i];
+	Nodelev = q;
+	for(i = 0; i<Nnodes; i++) Nodelev[cnt[Node[i].level]++] = &Node[i];
+	free(cnt);
+	return 1;
 }
 
 /*-----------------------------------------------------------------------
 input: None
-output: level
-called by: user
-description: logic simulation logic()
+output: nothing
+called by: cread
+description: build the compiled netlist Cnet from Nodelev. Nodes are
+  renumbered by their position in Nodelev, fan-ins are copied into one
+  CSR array and the fan-outs are derived from it. Must run after lev().
 author: Li
 -----------------------------------------------------------------------*/
-
-/* give a dec, change to binary and save into input array */
-void DectobinInput(int i){
-	int j,s = 0;
-	for(j = 0;j<Npi;j++){
-		input[j] = i%2;
-		i = i/2;
-	}
-}
-
-/* read input array into nodes value */
-void setinput(){
-	int i;
-	for(i = 0;i<Npi;i++){
-		Pinput[i]->val = input[i];
-	}
-}
-
-/* get a array ordered by the gate lev Time complex N*N BAD*/
-void setNodelev(){
-	Nodelev = (NSTRUC **) malloc(Nnodes * sizeof(NSTRUC *));
-	int n = 0,i,j;
-	for(i = 0;i<=lev_max;i++){
-		for(j =0;j<Nnodes;j++){
-			if(Node[j].level == i){
-				Nodelev[n]= &Node[j];
-				n++;
-			}
-		}
-	}
-}
-
-/*calval(Nodelev[i]->type,Nodelev[i]->unodes[0]->val,Nodelev[i]->unodes[1]->val); */
-int calval(int type,int i, int j){
-	switch(type){
-		case 2: return xor(i,j);
-		case 3: return or(i,j);
-		case 4: return nor(i,j);
-		case 5: return not(i);
-		case 6: return nand(i,j);
-		case 7: return and(i,j); 
-	}
-}
-
-int getval(NSTRUC* n,int lo, int high){
-	if((high-lo+1)== 1){  // only 1 input for primary gate or this node is primary input
-		return n->unodes[lo]->val;
-	}else{
-		int mid =lo+(high-lo-1)/2;
-		return calval(n->type,getval(n,lo,mid),getval(n,mid+1,high));	
-	}
-}
-
-void levsim(){
-	int i,j;
-	for(i = Npi; i<Nnodes;i++){
-		if(Nodelev[i]->type !=1){
-			Nodelev[i]->val = getval(Nodelev[i],0,Nodelev[i]->fin-1); /*get val according the input number*/
-		}
-		else Nodelev[i]->val = Nodelev[i]->unodes[0]->val; /* branch, just get upnode val */
+void compile(){
+	int i,j,k,nfi = 0;
+	int *pos;
+	NSTRUC *np;
+	for(i = 0;i<Nnodes;i++) nfi += Node[i].fin;
+	Cnet = cnet_new(Nnodes,nfi,Npi,Npo,lev_max+1);
+	pos = (int *) malloc(Nnodes * sizeof(int));
+	for(i = 0;i<Nnodes;i++) pos[Nodelev[i]->indx] = i;
+	k = 0;
+	for(i = 0;i<Nnodes;i++){
+		np = Nodelev[i];
+		Cnet->type[i] = np->type;
+		Cnet->level[i] = np->level;
+		Cnet->num[i] = np->num;
+		Cnet->fioff[i] = k;
+		for(j = 0;j<np->fin;j++) Cnet->fi[k++] = pos[np->unodes[j]->indx];
 	}
+	Cnet->fioff[Nnodes] = k;
+	for(i = 0;i<Nnodes;i++) Cnet->ord[i] = Nodelev[i]->indx;
+	for(i = 0;i<Npi;i++) Cnet->pi[i] = pos[Pinput[i]->indx];
+	for(i = 0;i<Npo;i++) Cnet->po[i] = pos[Poutput[i]->indx];
+	for(i = 0;i<=Cnet->nlev;i++) Cnet->levoff[i] = Levoff[i];
+	cnet_fanout(Cnet);
+	free(pos);
 }
 
 
-logic(){
-	FILE *fp = fopen("output.txt","w");
-	int i,j;
-	fputs("Primary Inputs: ",fp);
-	fputs("->>>>>>>>>>>\t\t\t\t\tPrimary outputs:\n",fp);	
-   	for(j = 0;j<pow(2,Npi)&&j<1000;j++){		
-		DectobinInput(j);
-		setinput();
-		for(i = Npi-1; i>=0; i--) fputc(Pinput[i]->val+'0',fp);
-		levsim();
-		fputs("\t\t\t\t\t\t\t",fp);	
-   		for(i = 0; i<Npo; i++) fputc(Poutput[i]->val+'0',fp);
-		fputs("\n",fp);
-	}
-   	printf("=>logic simualtion done, check output.txt file");	
-	fclose(fp);	
-}
 /*-----------------------------------------------------------------------
-input: None
-output:
+input: optional block width 64, 256 or 512, -n count (or all), -f first
+  pattern, -g for Gray code, -p pattern file, -b for binary output and
+  -o output file
+output: nothing
 called by: user
-description: fault collaspe
+description: LOGIC, stream patterns through the bit-parallel simulator
+  of lsim.c into output.txt (output.bin with -b). Without -p the input
+  counter runs from -f (0) for -n patterns, by default all of them for
+  fewer than 10 PIs and 1000 otherwise. The block width defaults to the
+  widest the CPU runs natively (512 with AVX-512, 256 with AVX2). A
+  failed write of the output is reported instead of the summary.
 author: Li
 -----------------------------------------------------------------------*/
-
-
-/* 0 is no dom eq, 1 have dom and eq, need delete */
-int checkeq(struct n_struc* ne,int f1,struct n_struc* nc,int f2){
-		int type;
-		if(ne->dnodes[0]->num != nc->dnodes[0]->num)
-			return 0;
-		else 
-			type = ne->dnodes[0]->type;
-		switch(type){
-		case 2: return 0;
-		case 3: if(f1 == 1 && f2 == 1) return 1;
-				else return 1; 
-		case 4: if(f1 == 1 && f2 == 1) return 1;
-				else return 0;
-		case 5: return 0;
-		case 6: if(f1 == 0 && f2 == 0) return 1;
-				else return 0;
-		case 7: if(f1 == 0 && f2 == 0) return 1;
-				else return 0; 
+logic(cp)
+char *cp;
+{
+	struct lsrc s;
+	struct lsink k;
+	struct timespec t0, t1;
+	char *tok, *pat = NULL, *out = NULL;
+	int lanes = 0, gray = 0, fmt = LF_TEXT, ok;
+	unsigned long long first = 0, count = Npi < 10 ? 1ULL << Npi : 1000, n;
+	double sec;
+
+	for(tok = strtok(cp, " \t\n"); tok; tok = strtok(NULL, " \t\n")){
+		if(strcmp(tok, "-n") == 0 && (tok = strtok(NULL, " \t\n"))){
+			if(strcmp(tok, "all") == 0) count = Npi < 64 ? 1ULL << Npi : ~0ULL;
+			else count = strtoull(tok, NULL, 0);
+		}
+		else if(strcmp(tok, "-f") == 0 && (tok = strtok(NULL, " \t\n"))) first = strtoull(tok, NULL, 0);
+		else if(strcmp(tok, "-p") == 0 && (tok = strtok(NULL, " \t\n"))) pat = tok;
+		else if(strcmp(tok, "-o") == 0 && (tok = strtok(NULL, " \t\n"))) out = tok;
+		else if(strcmp(tok, "-g") == 0) gray = 1;
+		else if(strcmp(tok, "-b") == 0) fmt = LF_BIN;
+		else if(strcmp(tok, "64") == 0) lanes = 1;
+		else if(strcmp(tok, "256") == 0) lanes = 4;
+		else if(strcmp(tok, "512") == 0) lanes = 8;
 	}
-}
-
-int checkeqd(struct n_struc* ne,int f1,struct n_struc* nc,int f2){
-		int type;
-		if(ne->dnodes[0]->num != nc->dnodes[0]->num)
+	if(lanes == 0) lanes = cnet_lanes();
+	if(out == NULL) out = fmt == LF_BIN ? "output.bin" : "output.txt";
+	if(pat){
+		if(!ls_file(&s, Npi, pat)){
+			printf("File %s does not exist!\n", pat);
 			return 0;
-		else 
-			type = ne->dnodes[0]->type;
-		switch(type){
-		case 2: return 0;
-		case 3: if(f1 == 1 && f2 == 1) return 1;
-				else return 1; 
-		case 4: if(f1 == 1 && f2 == 0) return 1;
-				else return 0;
-		case 5: return 0;
-		case 6: if(f1 == 0 && f2 == 1) return 1;
-				else return 0;
-		case 7: if(f1 == 0 && f2 == 0) return 1;
-				else return 0; 
-	}
-}
-
-
-
-int checkdom(struct n_struc* ne,int f1,struct n_struc* nc,int f2){
-		int type = nc->type;
-		switch(type){
-		case 2: return 0;
-		case 3: if(f1 == 1 && f2 == 1) return 1;
-				else return 0; 
-		case 4: if(f1 == 1 && f2 == 0) return 1;
-				else return 0;
-		case 5: return 0;
-		case 6: if(f1 ==0 && f2== 1) return 1;
-				else return 0;
-		case 7: if(f1 ==0 && f2 == 0) return 1;
-				else return 0; 
 		}
-}
-
-int check(struct n_struc *nc, int fval){
-    NSTRUC *nd = nc->dnodes[0];
-	NSTRUC *ne;
-	if(nd->fin == 1) return 0;
-	if(nd->unodes[0] == nc) ne = nd->unodes[1];
-	else ne = nd->unodes[0];
-	int i;
-	NSTRUC *ni;
-	if(checkeq(ne,0,nc,fval)){
-		/*printf("%d  val = 0\n",ne->num);*/
-		if(ne->type == 0)	return 1;
-		else 
-			for(i = 0; i<ne->fin;i++){
-				ni = ne->unodes[i];
-				if(ni->type == 0)	return 1;
-				if(checkeqd(ni,0,ne,0))	 
-					if(check(ni, 0))
-						return 1;
-				if(checkeqd(ni,1,ne,0))	 
-					if(check(ni, 1))
-						return 1;
-			}				
-	}else if(checkeq(ne,1,nc,fval)){
-		//printf("%d  val = 1\n",ne->num);
-		if(ne->type == 0)	return 1;
-		else 
-			for(i = 0; i<ne->fin;i++){
-				ni = ne->unodes[i];
-				if(ni->type == 0)	return 1;
-				if(checkeqd(ni,0,ne,1))	 
-					if(check(ni, 0))
-						return 1;
-				if(checkeqd(ni,1,ne,1))	 
-					if(check(ni, 1))
-						return 1;
-			}	
 	}
-	if(nc->type >1 && nc->type < 8 && nc->type != 5){
-		int i;
-		NSTRUC *ni;
-		for(i = 0; i< nc->fin;i++){
-			ni = nc->unodes[i];
-			if(checkdom(ni,0,nc,fval))
-				if(check(ni,0)) return 1;
-			else if(checkdom(ni,1,nc,fval))
-				if(check(ni,1)) return 1;
-		}
-	}		
+	else ls_count(&s, Npi, gray, first, count);
+	if(!lk_open(&k, out, 1 << 22)){
+		printf("Cannot write %s\n", out);
+		ls_close(&s);
+		return 0;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	n = lsim(Cnet, &s, &k, fmt, lanes);
+	ok = lk_close(&k);
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	ls_close(&s);
+	if(!ok){
+		printf("Cannot write %s: %s (%llu bytes written)", out, strerror(k.err), k.bytes);
+		return 0;
+	}
+	sec = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+	printf("=>logic simualtion done (%llu patterns, %d per pass, %0.3f s, %0.1f MB/s), check %s file",
+		n, 64*lanes, sec, sec > 0 ? k.bytes / sec / 1e6 : 0.0, out);
 	return 0;
 }
-
-void initFArr(){
-	lev();
+/* get orignal fault list, sorted by level since it follows Nodelev */
+void setFArr(){
 	int i,j=0;
-	int nc = 0;
-	FILE *fp = fopen("fault_original.txt","w");
-    /* get orignal fault list , write into file */
 	for(i=0;i<2*Nnodes;i++){
 		FArr[i].fval = j;
 		FArr[i].Np = Nodelev[i/2]; /* use nodelev, the Farr will be sorted by level */
@@ -729,447 +963,686 @@ void initFArr(){
 		if(j == 0) FArr[i].Np->sa0 = i;
 		else FArr[i].Np->sa1 = i;
 		j = (j+1)%2;
-		fprintf(fp,"Line: %d, Fault: %d \n",FArr[i].fnum,FArr[i].fval,fp);
-        /* get the collapsed fault by check point theory */
-		if(FArr[i].Np->type == 1 || FArr[i].Np->type == 0) Fcp[nc++]=&FArr[i];
 	}
+}
+
+/*-----------------------------------------------------------------------
+input: None
+output:
+called by: cread
+description: fault collaspe with fcoll.c into Fchead. fault_collapse.txt
+  gets every kept fault with the members of its equivalence class.
+author: Li
+-----------------------------------------------------------------------*/
+void initFArr(){
+	int i, k, nf, ncls = 0;
+	int *rep = (int *) malloc(2 * Nnodes * sizeof(int));
+	int *flist = (int *) malloc(2 * Nnodes * sizeof(int));
+	int *head = (int *) malloc(2 * Nnodes * sizeof(int));
+	int *nxt = (int *) malloc(2 * Nnodes * sizeof(int));
+	struct fList *br = Fchead;
+	FILE *fp;
+	setFArr();
+	fp = fopen("fault_original.txt","w");
+    /* write orignal fault list into file */
+	for(i=0;i<2*Nnodes;i++)
+		fprintf(fp,"Line: %d, Fault: %d \n",FArr[i].fnum,FArr[i].fval);
 	fclose(fp);
-    struct fList *br = Fchead;
-    struct fList *new;
-    /* store the fcp sorted by gate level large to small order */
-	for(i = 2*(Npi+Nbr)-1;i>=0;i--){
-		new = (struct fList*)malloc(sizeof(struct fList));
-		new->fp = Fcp[i];
-		new->next = NULL;
-		br->next = new;
-		br = br->next; 	
-	}
-	struct fList *pre = Fchead;
-	struct fList *brr;
-	br = Fchead->next;
-	while(br){
-		//printf("%d %d\n",br->fp->Np->num,br->fp->fval);
-		int flag = 0;
-		/* check dom */
-		if(br->fp->Np->type != 0)
-			if(check(br->fp->Np,br->fp->fval))
-				flag = 1;
-		/* check equal if no dom */
-		if(flag == 0){
-			brr = br->next;
-			while(brr){
-				if(checkeq(brr->fp->Np,0,br->fp->Np,br->fp->fval))
-					flag = 1;
-				else if(checkeq(brr->fp->Np,1,br->fp->Np,br->fp->fval))
-					flag = 1;
-				brr = brr->next;			
-			}
-		}	
-		if(flag == 1)			
-				pre->next = br->next;
-			else 
-				pre = pre->next;	
-		br = br->next;
+	nf = fcoll(Cnet, rep, flist);
+	Fchead->next = NULL;
+	for(k = 0; k < nf; k++) br = addfList(br, &FArr[flist[k]]);
+	/* members of each class in FArr order */
+	for(i = 0; i < 2*Nnodes; i++) head[i] = -1;
+	for(i = 2*Nnodes - 1; i >= 0; i--){
+		nxt[i] = head[rep[i]];
+		head[rep[i]] = i;
+		if(rep[i] == i) ncls++;
 	}
     /* write file */
-	br = Fchead->next;
 	fp = fopen("fault_collapse.txt","w");
-	while(br){
-		fprintf(fp,"Line: %d, Fault: %d \n",br->fp->fnum,br->fp->fval);
-		br = br->next;	
+	for(k = 0; k < nf; k++){
+		fprintf(fp,"Line: %d, Fault: %d, Class:",FArr[flist[k]].fnum,FArr[flist[k]].fval);
+		for(i = head[flist[k]]; i >= 0; i = nxt[i])
+			fprintf(fp," %d/%d",FArr[i].fnum,FArr[i].fval);
+		fputc('\n',fp);
 	}
 	fclose(fp);
+	free(rep);
+	free(flist);
+	free(head);
+	free(nxt);
+	printf("Faults = %d, classes = %d, collapsed = %d\n", 2*Nnodes, ncls, nf);
 	printf("======> fault collapse done, check fault_collapse.txt and fault_original.txt \n");
 }
 
 /*-----------------------------------------------------------------------
-input: None
-output:
-called by: user
-description: DFS
+input: bitmap of the detected FArr faults, their number, right and
+  wrong vector counts
+output: nothing
+called by: tgrade, PPSFP_client, CFS_client
+description: the grading summary. Fault coverage is over the collapsed
+  list Fchead, the detected count over all 2*Nnodes faults, and the
+  vector count is that of Ptest.
 author: Li
 -----------------------------------------------------------------------*/
-struct fList* copyfList(struct fList *l1){
-	struct fList* head = (struct fList*)malloc(sizeof(struct fList));
-	struct fList* new;
-	struct fList* br = l1->next;
-	struct fList* brr = head;
-	while(br){
-		new = (struct fList*)malloc(sizeof(struct fList));
-		new->fp = br->fp;
-		new->next = NULL;
-		brr->next = new;
-		brr = brr->next;
-		br = br->next;
+void greport(const uint64_t *det, int nd, int right, int wrong)
+{
+	struct fList *br;
+	int f, nc = 0, ncd = 0;
+	for(br = Fchead->next; br; br = br->next){
+		f = br->fp - FArr;
+		nc++;
+		ncd += (det[f >> 6] >> (f & 63)) & 1;
 	}
-	return head;
+	printf("----------------------------------------------------\n");
+	printf("Fault coverage  = %0.2f%% (%d of %d collapsed faults)\n",
+		nc ? (ncd+0.0)*100/nc : 0.0, ncd, nc);
+	printf("Faults detected = %d of %d (%0.2f%%)\n", nd, 2*Nnodes, (nd+0.0)*100/(2*Nnodes));
+	printf("Total test vector = %d\nRight test vector = %d\nWrong test vector = %d",Ptest.n,right,wrong);
 }
 
-void addfList(struct fList* head,struct fault *fp){
-	struct fList* br = head;
-	while(br->next) br = br->next;
-	struct fList* new = (struct fList*)malloc(sizeof(struct fList));
-	br->next = new;
-	new->fp = fp;
-	new->next = NULL;
+/* bitmap of the faults with detvec[f] >= 0, free it after use */
+uint64_t *detbits(const int *detvec)
+{
+	uint64_t *det = (uint64_t *) calloc((2*Nnodes + 63) / 64, sizeof(uint64_t));
+	int f;
+	for(f = 0; f < 2*Nnodes; f++)
+		if(detvec[f] >= 0) det[f >> 6] |= 1ULL << (f & 63);
+	return det;
 }
 
-void mergefList(struct fList* head,struct fList* l1){
-	struct fList* br = head;
-	while(br->next) br = br->next;
-	br->next = copyfList(l1)->next;
+/*-----------------------------------------------------------------------
+input: 1 for PFS, 0 for DFS, right and wrong counters
+output: nothing
+called by: DFS_client, PFS_client
+description: grade the DAL vectors on Nthreads workers with the work
+  stealing pool of tsim.c, dropping faults once any worker detects them.
+author: Li
+-----------------------------------------------------------------------*/
+void tgrade(int pfs, int *sn, int *fn)
+{
+	int nv = Ptest.n, nd, i;
+	int *ok = (int *) malloc((nv + 1) * sizeof(int));
+	uint64_t *det = (uint64_t *) malloc(((2*Nnodes + 63) / 64) * sizeof(uint64_t));
+	nd = tsim_grade(Cnet, &Ptest, ok, det, pfs, Nthreads);
+	for(*sn = *fn = i = 0; i < nv; i++){
+		if(ok[i]) (*sn)++;
+		else (*fn)++;
+	}
+	greport(det, nd, *sn, *fn);
+	free(ok);
+	free(det);
 }
 
-int getconval(int type){
-	switch(type){
-		case 3: return 1;
-		case 4: return 1;
-		case 6: return 0;
-		case 7: return 0; 
-	}
+/* append fault fp after tail, returns the new tail */
+struct fList* addfList(struct fList* tail,struct fault *fp){
+	struct fList* new = (struct fList*)malloc(sizeof(struct fList));
+	tail->next = new;
+	new->fp = fp;
+	new->next = NULL;
+	return new;
 }
 
-int checkconval(struct n_struc *Np, int *num){
-	int i,j = 0;
-	if(Np->type == 1 || Np->type == 2 || Np->type == 5)
+/*-----------------------------------------------------------------------
+input: None
+output: 
+called by: user
+description: DFS, grade the DAL vectors with the deductive fault
+  simulator of dfsim.c on Nthreads workers.
+author: Li
+-----------------------------------------------------------------------*/
+int DFS_client()
+{
+	if(Ptest.npi == 0){
+		printf("Do the DAL command first");
 		return 0;
-	int c = getconval(Np->type);
-	for(i = 0; i<Np->fin;i++){
-		if(c == Np->unodes[i]->val){
-			j++;
-			*num = i;
-		}
 	}
-	return j;
+	tgrade(0, &dsnum, &dfnum);
+	return 0;
 }
 
-struct fList* DFSs(int *Nip)
+/*-----------------------------------------------------------------------
+input: None
+output: 
+called by: user
+description: PFS, grade the DAL vectors 64 faults per word; only the
+  gates the fault effects reach are traced, with ev_wrun (tsim.c).
+author: vinay
+-----------------------------------------------------------------------*/
+int PFS_client()
 {
-	input = Nip;
-    /* get logic sim */
-	setinput();
-	levsim();
-    int i,j;
-    int index;
-    int* num;
-    struct fList* fee;
-	for(i = 0;i<Nnodes;i++){
-		if(Nodelev[i]->head->next){
-			fee = Nodelev[i]->head->next;
-			Nodelev[i]->head->next = NULL;
-			free(fee);
-		}
-			
-	}
-    for(i = 0;i<Nnodes;i++)
-	{
-		//printf("%d\n",Nodelev[i]->val);
-		//printf("%d\n",Nodelev[i]->num);
-		if(Nodelev[i]->val == 0) addfList(Nodelev[i]->head,&FArr[Nodelev[i]->sa1]);
-		else addfList(Nodelev[i]->head,&FArr[Nodelev[i]->sa0]);
-        num = (int*)malloc(sizeof(int));
-		index = checkconval(Nodelev[i],num);
-		if(Nodelev[i]->type != 0)
-		{
-			if(index == 1) mergefList(Nodelev[i]->head,Nodelev[i]->unodes[*num]->head);
-			else if(index == 0)
-				for(j = 0; j<Nodelev[i]->fin;j++)
-					mergefList(Nodelev[i]->head,Nodelev[i]->unodes[j]->head);	
-		}
-	}
-	struct fList* head = (struct fList*) malloc(sizeof(struct fList));
-	head->next = NULL;
-	for(i = 0; i<Npo; i++){
-		mergefList(head,Poutput[i]->head);
+	if(Ptest.npi == 0){
+		printf("Do the DAL command first");
+		return 0;
 	}
-	free(num);
-	return head;
+	tgrade(1, &psnum, &pfnum);
+	return 0;
 }
 
-int DFS_client()
+/*-----------------------------------------------------------------------
+input: None
+output: 
+called by: user
+description: PPSFP, grade the DAL vectors with the parallel-pattern
+  single-fault propagation engine of fsim.c. Every fault of FArr is
+  simulated until a vector detects it and then dropped. A vector is
+  right when it detects the fault it was generated for, as in PFS.
+author: Li
+-----------------------------------------------------------------------*/
+int PPSFP_client()
 {
-	/*DectobinInput(0);
-	struct fList* head = DFSs(input);
-	struct fList* br = head->next;
-	while(br){
-		printf("line = %d ; type = %d; lev = %d\n", br->fp->fnum,br->fp->fval, br->fp->Np->level);
-		br = br->next;	
-	}
-	return 0;*/
-	if(siphead == NULL){
+	if(Ptest.npi == 0){
 		printf("Do the DAL command first");
 		return 0;
 	}
-    dsnum = dfnum = 0;
-	struct ipList* brr = siphead->next;
-	struct fList* head;
-	struct fList* br;
-	while(brr){
-	 	head = DFSs(brr->Nip);
-	 	br	= head->next;
-		int flag = 0;
-		while(br){
-				if(br->fp == brr->fp) flag = 1;
-				br = br->next;
+	struct ppsfp s;
+	int nv = Ptest.n, nd, i, b, nb;
+	int right = 0, wrong = 0;
+	uint64_t *det;
+	int *flist = (int *) malloc(2 * Nnodes * sizeof(int));
+	int *detvec = (int *) malloc(2 * Nnodes * sizeof(int));
+	for(i = 0; i < 2*Nnodes; i++) flist[i] = i;
+	nd = tsim_ppsfp(Cnet, &Ptest, flist, 2*Nnodes, detvec, Nthreads);
+	/* check each vector against its own target fault */
+	ppsfp_init(&s, Cnet);
+	for(i = 0; i < nv; i += 64){
+		nb = nv - i < 64 ? nv - i : 64;
+		ppsfp_load(&s, &Ptest, i, nb);
+		for(b = 0; b < nb; b++){
+			if(ppsfp_fault(&s, Ptest.tgt[i+b], 1ULL << b)) right++;
+			else wrong++;
 		}
-		if(flag == 1){ dsnum++;}
-		else{ //printf("Test vector for line = %d fault %d fail\n",brr->fp->fnum,brr->fp->fval);
-			dfnum++;
-		}
-		brr = brr->next;
 	}
-	printf("----------------------------------------------------\n");
-	printf("Fault coverage  = %0.2f%% \n", (dsnum+0.0)*100/(snum+fnum));
-	printf("Total test vector = %d\nRight test vector = %d\nWrong test vector = %d",snum,dsnum,dfnum);
-
+	ppsfp_free(&s);
+	det = detbits(detvec);
+	greport(det, nd, right, wrong);
+	free(det);
+	free(flist);
+	free(detvec);
 	return 0;
 }
 
 /*-----------------------------------------------------------------------
 input: None
-output: level
+output: 
 called by: user
-description: PFS
-author: vinay
+description: CFS, grade the DAL vectors with the concurrent fault
+  simulator of cfsim.c. Same report as PPSFP.
+author: Li
 -----------------------------------------------------------------------*/
-/* for print binary */
-void printb(unsigned n){
-	if(!n) printf("0");		
-	while (n) {
-		if (n%2 == 1)
-		    printf("1");
-		else
-		    printf("0");
-
-		n = n/2;
+int CFS_client()
+{
+	if(Ptest.npi == 0){
+		printf("Do the DAL command first");
+		return 0;
 	}
-	 //printf("\n");
+	int nv = Ptest.n, nd, i;
+	int right = 0;
+	uint64_t *det;
+	int *ok = (int *) malloc((nv + 1) * sizeof(int));
+	int *detvec = (int *) malloc(2 * Nnodes * sizeof(int));
+	nd = cfsim(Cnet, &Ptest, 1, ok, detvec);
+	for(i = 0; i < nv; i++) right += ok[i];
+	det = detbits(detvec);
+	greport(det, nd, right, nv-right);
+	free(det);
+	free(ok);
+	free(detvec);
+	return 0;
 }
 
-void printmask(unsigned* ormk, unsigned *andmk)
+/*-----------------------------------------------------------------------
+input: thread count, empty for the current one
+output: 
+called by: user
+description: THREADS, set the number of workers of DFS, PFS and PPSFP.
+author: Li
+-----------------------------------------------------------------------*/
+int threads(cp)
+char *cp;
 {
-	int i;	
-	for(i = 0;i<Nnodes;i++)
-    {
-		printf("line %d \n",Node[i].num);
-		printf("andmask = ");
-		printb(andmk[i]);
-		printf("\n");
-		printf("ormask  = ");
-		printb(ormk[i]);
-		printf("\n");
-	}
+	int n;
+	if(sscanf(cp,"%d",&n) == 1) Nthreads = tsim_nthreads(n);
+	printf("==> %d fault simulation thread%s", Nthreads, Nthreads > 1 ? "s" : "");
+	return 0;
 }
 
-/*set mask  */
-
-void setbinary(unsigned* mk, int i, int val, int index)
+/*-----------------------------------------------------------------------
+input: optional -b backtrack limit and -t time limit in seconds, both
+  per fault
+output: 
+called by: user
+description: DAL, run the D-algorithm of dalg.c on every fault of the
+  collapsed list. Tests go to Ptest and Dal.txt, faults without a
+  test to fiphead and dal_failed.txt.
+author: Li
+-----------------------------------------------------------------------*/
+int D_client(cp)
+char *cp;
 {
-	if(val == 0)
-		mk[index] = mk[index] - pow(2,i);
-	else 
-		mk[index] = mk[index] + pow(2,i); 
+	struct dalg d;
+	long maxbt = 1000;
+	double maxsec = 1;
+
+	atpgopts(cp, &maxbt, &maxsec);
+	dalg_init(&d, Cnet, maxbt, maxsec);
+	atpgrun(dalgen, &d, &d.bt, "Dal.txt", "dal_failed.txt");
+	dalg_free(&d);
+	printf("\n======> check Dal.txt and dal_failed.txt");
+	return 0;
 }
 
 
-void setmask(unsigned* ormk, unsigned *andmk,int lo, int hi)
+/* free a fault list, head included */
+void freeflist(struct fList **head)
 {
-	int j;
-	int val, num , index;
-	for(j = lo;j<hi;j++){
-		val = FArr[j].fval;
-		num = FArr[j].fnum;
-		index = FArr[j].Np->indx;
-		if(val == 0) setbinary(andmk,j-lo,val,index);
-		else setbinary(ormk,j-lo,val,index); 
+	struct fList *br, *nxt;
+	for(br = *head; br; br = nxt){
+		nxt = br->next;
+		free(br);
 	}
+	*head = NULL;
 }
 
-void resetmask(unsigned* ormk, unsigned *andmk)
+/* -b backtracks and -t seconds per fault, -r gain and -s seed of the
+   random phase, -c for cube merging, -x 0, 1, r(andom) or a(djacent)
+   fill of the X inputs, from the command line */
+void atpgopts(char *cp, long *maxbt, double *maxsec)
 {
-	int i;
-	for(i = 0 ; i<Nnodes; i++)
-    {
-		andmk[i] = 0xFFFFFFFF;
-		ormk[i] = 0x00000000;
+	char *tok;
+	Rgain = 0;
+	Rseed = 1;
+	Dcompact = 0;
+	Xfill = XF_0;
+	for(tok = strtok(cp, " \t\n"); tok; tok = strtok(NULL, " \t\n")){
+		if(strcmp(tok, "-b") == 0 && (tok = strtok(NULL, " \t\n"))) *maxbt = atol(tok);
+		else if(strcmp(tok, "-t") == 0 && (tok = strtok(NULL, " \t\n"))) *maxsec = atof(tok);
+		else if(strcmp(tok, "-r") == 0 && (tok = strtok(NULL, " \t\n"))) Rgain = atof(tok);
+		else if(strcmp(tok, "-s") == 0 && (tok = strtok(NULL, " \t\n"))) Rseed = strtoull(tok, NULL, 0);
+		else if(strcmp(tok, "-c") == 0) Dcompact = 1;
+		else if(strcmp(tok, "-x") == 0 && (tok = strtok(NULL, " \t\n"))){
+			if(*tok == '1') Xfill = XF_1;
+			else if(*tok == 'r') Xfill = XF_RAND;
+			else if(*tok == 'a') Xfill = XF_ADJ;
+		}
 	}
 }
 
-/* cal val */
-void psetinput()
+/*-----------------------------------------------------------------------
+input: test generator for one fault, its state, its backtrack counter,
+  names of the test and failure files (or NULL)
+output: nothing
+called by: podemS, fanS, satS, D_client
+description: run the generator on every fault of the collapsed list.
+  Detected faults put their test cube in Ptest, redundant and aborted
+  ones go to fiphead, so DFS/PFS can grade the tests. The time of each
+  fault is measured and written with the test. With -r, random patterns
+  (rpt.c) go first and the generator only sees the faults they missed;
+  each kept pattern is stored with the first fault it detects, and its
+  detections are reported apart from the generator's. The X of the cubes
+  are filled after the last fault, as -x says.
+author: Li
+-----------------------------------------------------------------------*/
+void atpgrun(int (*gen)(void *, int, int *), void *s, const long *bt,
+	const char *okname, const char *badname)
 {
-	int i;
-	for(i = 0;i<Npi;i++)
-	{
-		if(input[i])
-			Pinput[i]->pval = 0xFFFFFFFF;
-		else 
-			Pinput[i]->pval = 0;
+	static const char *stname[] = {"detected", "redundant", "aborted"};
+	struct fList *br, *ft;
+	struct timespec t0, t1;
+	FILE *ok = okname ? fopen(okname, "w") : NULL;
+	FILE *bad = badname ? fopen(badname, "w") : NULL;
+	int cnt[3] = {0, 0, 0};
+	int r, i, k, *vec, *flist = NULL, *rdet = NULL, nf = 0, nr = 0;
+	int ntest = 0, nrd = 0;         /* generator tests, random detections */
+	uint64_t *p;
+	long tbt = 0;
+	double ms, tot = 0, trnd = 0, worst = 0;
+
+	ps_free(&Ptest);
+	ps_init(&Ptest, Npi);
+	freeflist(&fiphead);
+	ft = fiphead = (struct fList *) calloc(1, sizeof(struct fList));
+	if(Rgain > 0){
+		for(br = Fchead->next; br; br = br->next) nf++;
+		flist = (int *) malloc((nf + 1) * sizeof(int));
+		rdet = (int *) malloc((nf + 1) * sizeof(int));
+		for(k = 0, br = Fchead->next; br; br = br->next) flist[k++] = br->fp - FArr;
+		clock_gettime(CLOCK_MONOTONIC, &t0);
+		nr = rpt(Cnet, Rseed, Rgain / 100, flist, nf, rdet, &Ptest);
+		clock_gettime(CLOCK_MONOTONIC, &t1);
+		trnd = (t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) * 1e-6;
+		for(k = 0, br = Fchead->next; br; br = br->next, k++){
+			if(rdet[k] < 0) continue;
+			if(ok){
+				fprintf(ok, "Line: %d, Fault: %d, Test: ", br->fp->fnum, br->fp->fval);
+				for(r = 0; r < Npi; r++) fputc('0' + PS_BIT(PS_VAL(&Ptest, rdet[k]), r), ok);
+				fprintf(ok, ", Random\n");
+			}
+			nrd++;
+		}
+		printf("Random patterns = %d (%d faults, %0.3f s)\n", nr, nrd, trnd / 1e3);
 	}
+	vec = (int *) malloc((Npi + 1) * sizeof(int));
+	p = (uint64_t *) malloc((2 * Ptest.nw + 1) * sizeof(uint64_t));
+	for(k = 0, br = Fchead->next; br; br = br->next, k++){
+		if(rdet && rdet[k] >= 0) continue;
+		clock_gettime(CLOCK_MONOTONIC, &t0);
+		r = gen(s, br->fp - FArr, vec);
+		clock_gettime(CLOCK_MONOTONIC, &t1);
+		ms = (t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) * 1e-6;
+		tot += ms;
+		if(ms > worst) worst = ms;
+		tbt += *bt;
+		cnt[r]++;
+		if(r == T_DETECTED){
+			if(ok){
+				fprintf(ok, "Line: %d, Fault: %d, Test: ", br->fp->fnum, br->fp->fval);
+				for(i = 0; i < Npi; i++) fputc("01X"[vec[i]], ok);
+				fprintf(ok, ", Time: %0.3f ms\n", ms);
+			}
+			ntest++;
+			ps_pack(&Ptest, vec, p);
+			/* merge into the first cube that agrees on every specified PI */
+			for(i = Dcompact ? nr : Ptest.n; i < Ptest.n; i++)
+				if(ps_merge(&Ptest, i, p)) break;
+			if(i == Ptest.n) ps_addp(&Ptest, p, br->fp - FArr);
+		}
+		else{
+			if(bad) fprintf(bad, "Line: %d, Fault: %d, %s, Time: %0.3f ms\n",
+				br->fp->fnum, br->fp->fval, stname[r], ms);
+			ft = addfList(ft, br->fp);
+		}
+	}
+	free(vec);
+	free(p);
+	free(flist);
+	free(rdet);
+	ps_xfill(&Ptest, nr, Xfill, Rseed);
+	if(Dcompact) printf("Cubes merged = %d tests into %d vectors\n", ntest, Ptest.n - nr);
+	if(ok) fclose(ok);
+	if(bad) fclose(bad);
+	/* every collapsed fault ends in exactly one of the counts */
+	snum = nrd + cnt[T_DETECTED];
+	fnum = cnt[T_REDUNDANT] + cnt[T_ABORTED];
+	k = cnt[T_DETECTED] + fnum;
+	printf("----------------------------------------------------\n");
+	if(Rgain > 0) printf("Random detected = %d by %d patterns\n", nrd, nr);
+	printf("Detected = %d\nRedundant = %d\nAborted = %d\n",
+		cnt[T_DETECTED], cnt[T_REDUNDANT], cnt[T_ABORTED]);
+	printf("Fault coverage = %0.2f%% (%d of %d collapsed faults)\n",
+		(snum+fnum) ? (snum+0.0)*100/(snum+fnum) : 0.0, snum, snum+fnum);
+	printf("Vectors = %d (%ld bytes)\n", Ptest.n, (long) ps_bytes(&Ptest));
+	if(Rgain > 0) printf("Generated vectors = %d\n", Ptest.n - nr);
+	printf("Backtracks = %ld\nTime = %0.3f s\n",tbt,(trnd+tot)/1e3);
+	printf("Time per fault = %0.3f ms (max %0.3f ms)",k ? tot/k : 0.0,worst);
 }
 
-int calpval(int type,unsigned i,unsigned j){
-	switch(type){
-		case 2: return pxor(i,j);
-		case 3: return por(i,j);
-		case 4: return pnor(i,j);
-		case 5: return pnot(i);
-		case 6: return pnand(i,j);
-		case 7: return pand(i,j); 
-	}
+int podemgen(void *s, int f, int *vec)
+{
+	return podem((struct podem *) s, f, vec);
 }
 
-int getpval(NSTRUC* n,int lo, int high){
-	if((high-lo+1)== 1){  // only 1 input for primary gate or this node is primary input
-		return n->unodes[lo]->pval;
-	}else{
-		int mid =lo+(high-lo-1)/2;
-		return calpval(n->type,getpval(n,lo,mid),getpval(n,mid+1,high));	
-	}
+int dalgen(void *s, int f, int *vec)
+{
+	return dalg((struct dalg *) s, f, vec);
 }
 
-void parsim(unsigned* ormk, unsigned *andmk){
-	int i,j;
-	int index = 0;
-	for(i = 0; i<Nnodes;i++){
-		index = Nodelev[i]->indx;
-		if(Nodelev[i]->type > 1){
-			Nodelev[i]->pval = getpval(Nodelev[i],0,Nodelev[i]->fin-1); /*get val according the input number*/
-		}else if(Nodelev[i]->type == 1){
-			Nodelev[i]->pval = Nodelev[i]->unodes[0]->pval; 
-		}
-		/*printf("-----------------------\n");
-		printf("andmk = ");
-		printb(andmk[index]);
-		printf("\n");
-		printf("ormk = ");
-		printb(ormk[index]);
-		printf("\n");
-		printf("num: %d value: ",Nodelev[i]->num);		
-		printb(Nodelev[i]->pval);
-		printf("\n");*/
-
-		Nodelev[i]->pval = ((Nodelev[i]->pval)&andmk[index])|ormk[index];
-		
-		/*printf("Nodelev[i]-> num: %d value: ",Nodelev[i]->num);		
-		printb(Nodelev[i]->pval);
-		printf("\n");*/
-	}
+/*-----------------------------------------------------------------------
+input: optional -b backtrack limit and -t time limit in seconds, both
+  per fault
+output: 
+called by: user
+description: PODEM, run podem.c on every fault of the collapsed list.
+author: Li
+-----------------------------------------------------------------------*/
+int podemS(cp)
+char *cp;
+{
+	struct podem p;
+	long maxbt = 1000;
+	double maxsec = 1;
+
+	atpgopts(cp, &maxbt, &maxsec);
+	podem_init(&p, Cnet, maxbt, maxsec);
+	atpgrun(podemgen, &p, &p.bt, NULL, NULL);
+	podem_free(&p);
+	return 0;
 }
 
-void dectobinary(unsigned num,int *res,int lo,int hi){
-	int i;	
-	for(i = lo;i<hi;i++){
-		res[i-lo] = num%2;
-		num = num/2;
-	}
+int fangen(void *s, int f, int *vec)
+{
+	return fan((struct fan *) s, f, vec);
 }
 
+/*-----------------------------------------------------------------------
+input: optional -b backtrack limit and -t time limit in seconds, both
+  per fault
+output: 
+called by: user
+description: FAN, run fan.c on every fault of the collapsed list.
+author: Li
+-----------------------------------------------------------------------*/
+int fanS(cp)
+char *cp;
+{
+	struct fan p;
+	long maxbt = 1000;
+	double maxsec = 1;
+
+	atpgopts(cp, &maxbt, &maxsec);
+	fan_init(&p, Cnet, maxbt, maxsec);
+	atpgrun(fangen, &p, &p.bt, NULL, NULL);
+	fan_free(&p);
+	return 0;
+}
 
-struct fList* PFSs(int *Nip)
+int satgen(void *s, int f, int *vec)
 {
-	int bit = 32;
-	input = Nip;
-	setinput();
-	levsim();
-	unsigned ormk[Nnodes];
-	unsigned andmk[Nnodes];
-	int i,f,h;
-	int num = (2*Nnodes+bit-1)/bit;
-	int j = 2*Nnodes;
-	struct fList* head = (struct fList*)malloc(sizeof(struct fList));
-	head->next = NULL;
-	head->fp = NULL;
-	for(i = 0; i< num; i++)
-	{
-		/* set mask */		
-		resetmask(ormk, andmk);
-		//printmask(ormk,andmk);
-		if(j >= bit) setmask(ormk,andmk,i*bit,(i+1)*bit);
-		else setmask(ormk,andmk,i*bit,i*bit+j);
-		/* cal mask */
-		psetinput();
-		parsim(ormk,andmk);
-		int res[bit];
-		for(f = 0; f<Npo; f++)
-		{
-			if(j >= bit)
-			{ 
-				dectobinary(Poutput[f]->pval,res,i*bit,(i+1)*bit);
-				for(h = 0;h<bit;h++){
-					if(res[h] != Poutput[f]->val)
-					{
-						 addfList(head,&FArr[h+i*bit]);		
-					}	
-				}
-			}else
-			{ 
-				dectobinary(Poutput[f]->pval,res,i*bit,i*bit+j);
-				for(h = 0;h<j;h++){
-					if(res[h] != Poutput[f]->val)
-						 addfList(head,&FArr[h+i*bit]);		
-				}
-			}
-		}
-		j = j - bit;
-	}
-	/*struct fList* br = head->next;
-	while(br){
-		//printf("line num = %d , type = %d\n", br->fp->fnum,br->fp->fval);
-		br = br->next;
-	}*/
-	return head;
+	return satpg((struct satpg *) s, f, vec);
 }
-	
-int PFS_client()
+
+/*-----------------------------------------------------------------------
+input: optional -b conflict limit and -t time limit in seconds, both
+  per fault
+output: 
+called by: user
+description: SAT, run satpg.c on every fault of the collapsed list.
+author: Li
+-----------------------------------------------------------------------*/
+int satS(cp)
+char *cp;
 {
-	/*DectobinInput(12);
-	struct fList* head = PFSs(input);
-	return 0; */
-	if(siphead == NULL){
+	struct satpg p;
+	long maxbt = 10000;
+	double maxsec = 1;
+
+	atpgopts(cp, &maxbt, &maxsec);
+	satpg_init(&p, Cnet, maxbt, maxsec);
+	atpgrun(satgen, &p, &p.bt, NULL, NULL);
+	satpg_free(&p);
+	return 0;
+}
+
+/*-----------------------------------------------------------------------
+input: None
+output: 
+called by: user
+description: COMPACT, static compaction of the test vectors. The vectors
+  are fault simulated in reverse order with fault dropping over every
+  fault of FArr, and a vector that detects no fault left by the later
+  ones is removed. Coverage stays the same; the last vectors of an ATPG
+  run tend to be the most specific, so going backwards drops most. A
+  kept vector is graded against the first fault it still detects.
+author: Li
+-----------------------------------------------------------------------*/
+int compact()
+{
+	int *flist, *detvec, *own;
+	int nv = Ptest.n, i;
+
+	if(Ptest.npi == 0){
 		printf("Do the DAL command first");
 		return 0;
 	}
-	struct ipList* brr = siphead->next;
-	struct fList* head;
-	struct fList* br;
-	int flag;
-	psnum = pfnum = 0;
-	while(brr){
-	 	head = PFSs(brr->Nip);
-	 	br	= head->next;
-		flag = 0;
-		while(br){
-			//if(brr->fp->fnum == 1)
-				//printf("line num = %d , type = %d\n", br->fp->fnum,br->fp->fval);
-			if(br->fp == brr->fp) flag = 1;
-			br = br->next;	
-		}
-		if(flag == 1){ psnum++;}
-		else{ 
-			//printf("Test vector for line = %d fault %d fail\n",brr->fp->fnum,brr->fp->fval);
-			pfnum++;
-		}
-		brr = brr->next;
-	}
+	own = (int *) malloc((nv + 1) * sizeof(int));
+	flist = (int *) malloc(2 * Nnodes * sizeof(int));
+	detvec = (int *) malloc(2 * Nnodes * sizeof(int));
+	for(i = 0; i < 2*Nnodes; i++) flist[i] = i;
+	ps_reverse(&Ptest);
+	tsim_ppsfp(Cnet, &Ptest, flist, 2*Nnodes, detvec, Nthreads);
+	ps_reverse(&Ptest);
+	/* a kept vector now answers for the first fault it still detects */
+	for(i = 0; i < nv; i++) own[i] = -1;
+	for(i = 2*Nnodes - 1; i >= 0; i--)
+		if(detvec[i] >= 0) own[nv - 1 - detvec[i]] = i;
+	for(i = 0; i < nv; i++)
+		if(own[i] >= 0) Ptest.tgt[i] = own[i];
+	for(i = 0; i < nv; i++) own[i] = own[i] >= 0;
+	ps_keep(&Ptest, own);
 	printf("----------------------------------------------------\n");
-	printf("Fault coverage  = %0.2f%%\n", (psnum+0.0)*100/(snum+fnum));
-	printf("Total test vector = %d\nRight test vector = %d\nWrong test vector = %d",snum,psnum,pfnum);
+	printf("Vectors = %d -> %d (%0.2f%% fewer, ratio %0.2f)", nv, Ptest.n,
+		nv ? (nv - Ptest.n) * 100.0 / nv : 0.0, Ptest.n ? (double) nv / Ptest.n : 0.0);
+	free(own);
+	free(flist);
+	free(detvec);
 	return 0;
 }
 
+/* SCOAP cost of fault f, setting the line to the other value and seeing it */
+static long long scost(const CNET *c, int f)
+{
+	int i = f / 2;
+	return (long long) (f % 2 ? c->cc0[i] : c->cc1[i]) + c->co[i];
+}
 
-int D_client(){
-   printf("fail\n");
-
-   return 0;
+/* sift the cheapest of the n faults in h down from position k */
+static void sdown(const CNET *c, int *h, int n, int k)
+{
+	int j, t;
+	for(; (j = 2 * k + 1) < n; k = j){
+		if(j + 1 < n && scost(c, h[j + 1]) < scost(c, h[j])) j++;
+		if(scost(c, h[k]) <= scost(c, h[j])) break;
+		t = h[k]; h[k] = h[j]; h[j] = t;
+	}
 }
 
+/*-----------------------------------------------------------------------
+input: number of faults to list, 10 if empty
+output: 
+called by: user
+description: SCOAP, print the averages of the cached SCOAP columns, the
+  lines that cannot be observed, and the n faults of highest SCOAP cost
+  (CC1+CO for stuck-at-0, CC0+CO for stuck-at-1) with the hardest first.
+  The n hardest are kept in a heap with the cheapest on top, so one pass
+  over the faults is enough.
+author: Li
+-----------------------------------------------------------------------*/
+int scoapS(cp)
+char *cp;
+{
+	const CNET *c = Cnet;
+	int *h, n = 10, nh = 0, nu = 0, f, i, k;
+	char fs[32];
+	double s0 = 0, s1 = 0, so = 0;
+
+	if(sscanf(cp,"%d",&n) != 1 || n < 0) n = 10;
+	if(n > 2 * c->n) n = 2 * c->n;
+	h = (int *) malloc((n + 1) * sizeof(int));
+	for(i = 0; i < c->n; i++){
+		if(c->co[i] == SCOAP_INF) nu++;
+		else so += c->co[i];
+		s0 += c->cc0[i];
+		s1 += c->cc1[i];
+	}
+	for(f = 0; f < 2 * c->n; f++){
+		if(nh < n){
+			h[nh++] = f;
+			if(nh == n)
+				for(k = n / 2 - 1; k >= 0; k--) sdown(c, h, n, k);
+		}
+		else if(n && scost(c, f) > scost(c, h[0])){
+			h[0] = f;
+			sdown(c, h, n, 0);
+		}
+	}
+	if(nh < n)
+		for(k = nh / 2 - 1; k >= 0; k--) sdown(c, h, nh, k);
+	/* popping the cheapest leaves the hardest at the front */
+	for(k = nh - 1; k > 0; k--){
+		f = h[0]; h[0] = h[k]; h[k] = f;
+		sdown(c, h, k, 0);
+	}
+	printf("Lines = %d, average CC0 = %0.2f, CC1 = %0.2f, CO = %0.2f", c->n,
+		s0 / c->n, s1 / c->n, c->n > nu ? so / (c->n - nu) : 0.0);
+	printf(", unobservable = %d\n", nu);
+	printf("Fault         CC0     CC1      CO    Cost\n");
+	for(k = 0; k < nh; k++){
+		i = h[k] / 2;
+		sprintf(fs, "%d/%d", c->num[i], h[k] % 2);
+		printf("%-10s %7d %7d %7d", fs, c->cc0[i], c->cc1[i], c->co[i]);
+		if(scost(c, h[k]) >= SCOAP_INF) printf("     inf\n");
+		else printf(" %7lld\n", scost(c, h[k]));
+	}
+	free(h);
+	return 0;
+}
 
-int podemS(){
-	printf("fail\n");
+/*-----------------------------------------------------------------------
+input: compiler command, cc or $CC if empty
+output: 
+called by: user
+description: COMPILE, turn the circuit into straight-line simulation
+  code with ccsim.c. The bit-parallel simulation of LOGIC and the good
+  machine of PPSFP use it until the next READ.
+author: Li
+-----------------------------------------------------------------------*/
+int ccompile(cp)
+char *cp;
+{
+	char cc[MAXLINE];
+	struct timespec t0, t1;
+	int r;
+
+	if(sscanf(cp, "%s", cc) != 1) strcpy(cc, getenv("CC") ? getenv("CC") : "");
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	r = ccsim(Cnet, cc);
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	if(r == 0) printf("==> no compiler, the simulation stays interpreted");
+	else printf("==> compiled simulation %s (%0.3f s)", r == 2 ? "loaded from cache" : "built",
+		(t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9);
 	return 0;
+}
+
+/*-----------------------------------------------------------------------
+input: on or off, empty to only show the setting
+output: 
+called by: user
+description: TAPE, choose between the instruction tape of tape.c and the
+  netlist walking simulators of netlist.c. The loaded circuit gets or
+  loses its tape at once, and every later READ follows the setting.
+author: Li
+-----------------------------------------------------------------------*/
+int tapeS(cp)
+char *cp;
+{
+	char arg[MAXLINE];
 
+	if(sscanf(cp, "%s", arg) == 1){
+		if(strcasecmp(arg, "on") == 0) Usetape = 1;
+		else if(strcasecmp(arg, "off") == 0) Usetape = 0;
+		else{
+			printf("TAPE on or off");
+			return 0;
+		}
+	}
+	if(Cnet && Usetape && Cnet->tape == NULL) Cnet->tape = tape_build(Cnet);
+	if(Cnet && !Usetape){
+		tape_free(Cnet->tape);
+		Cnet->tape = NULL;
+	}
+	printf("==> instruction tape %s", Usetape ? "on" : "off");
+	return 0;
 }
+
 /*========================= End of program ============================*/
 
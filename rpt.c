@@ -0,0 +1,113 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "type.h"
+#include "netlist.h"
+#include "evsim.h"
+#include "pstore.h"
+#include "fsim.h"
+#include "rpt.h"
+
+/* the state is filled from the seed with splitmix64, never all zero */
+void rng_seed(struct rng *r, uint64_t seed)
+{
+	uint64_t z;
+	int k;
+	for(k = 0; k < 4; k++){
+		z = (seed += 0x9e3779b97f4a7c15ULL);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+		r->s[k] = z ^ (z >> 31);
+	}
+}
+
+#define ROTL(x, k) (((x) << (k)) | ((x) >> (64 - (k))))
+
+uint64_t rng_next(struct rng *r)
+{
+	uint64_t *s = r->s;
+	uint64_t x = ROTL(s[1] * 5, 7) * 9, t = s[1] << 17;
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = ROTL(s[3], 45);
+	return x;
+}
+
+/*-----------------------------------------------------------------------
+input: netlist, seed, smallest share of nf a block must detect to go
+  on, fault list of nf FArr ids, pattern store
+output: number of kept patterns, appended to ps with the first fault of
+  flist they detect as target; detvec[k] is the store index of the
+  pattern that detects flist[k], or -1
+called by: atpgrun
+description: random pattern phase with fault dropping.
+author: Li
+-----------------------------------------------------------------------*/
+int rpt(const CNET *c, uint64_t seed, double mingain, const int *flist,
+	int nf, int *detvec, struct pstore *ps)
+{
+	struct ppsfp s;
+	struct rng r;
+	uint64_t *piw = (uint64_t *) malloc((c->npi + 1) * sizeof(uint64_t));
+	uint64_t *p = (uint64_t *) malloc((2 * ps->nw + 1) * sizeof(uint64_t));
+	int *act = (int *) malloc((nf + 1) * sizeof(int));
+	int *hit = (int *) malloc((nf + 1) * sizeof(int));
+	int slot[64];
+	int na = 0, nv = 0, nd, i, j, k, b;
+	uint64_t det, used;
+
+	for(k = 0; k < nf; k++){
+		detvec[k] = -1;
+		act[na++] = k;
+	}
+	rng_seed(&r, seed);
+	ppsfp_init(&s, c);
+	while(na){
+		for(i = 0; i < c->npi; i++) piw[i] = rng_next(&r);
+		ppsfp_wload(&s, piw);
+		used = 0;
+		for(nd = j = k = 0; k < na; k++){
+			det = ppsfp_fault(&s, flist[act[k]], ~0ULL);
+			if(!det){
+				act[j++] = act[k];
+				continue;
+			}
+			b = __builtin_ctzll(det & used ? det & used : det);
+			used |= 1ULL << b;
+			detvec[act[k]] = b;     /* pattern number until it is kept */
+			hit[nd++] = act[k];
+		}
+		/* keep the patterns some fault was dropped with */
+		for(b = 0; b < 64; b++){
+			if(!(used >> b & 1)) continue;
+			memset(p, 0, ps->nw * sizeof(uint64_t));
+			for(i = 0; i < c->npi; i++) p[i >> 6] |= (piw[i] >> b & 1) << (i & 63);
+			for(i = 0; i < ps->nw; i++) p[ps->nw + i] = ~0ULL;
+			if(c->npi % 64) p[2 * ps->nw - 1] = (1ULL << c->npi % 64) - 1;
+			slot[b] = ps_addp(ps, p, -1);
+			nv++;
+		}
+		/* hit is in flist order, the first fault of a pattern owns it */
+		for(k = 0; k < nd; k++){
+			detvec[hit[k]] = slot[detvec[hit[k]]];
+			if(ps->tgt[detvec[hit[k]]] < 0) ps->tgt[detvec[hit[k]]] = flist[hit[k]];
+		}
+		na = j;
+		if(nd < mingain * nf || nd == 0) break;
+	}
+	ppsfp_free(&s);
+	free(piw);
+	free(p);
+	free(act);
+	free(hit);
+	return nv;
+}
@@ -0,0 +1,24 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+/*-----------------------------------------------------------------------
+  random pattern phase
+
+  Blocks of 64 random patterns, one word per PI from a seeded xoshiro256**
+  generator, are fault simulated with PPSFP against a fault list and the
+  detected faults are dropped. A block keeps only the patterns that
+  were the first to detect some fault, preferring patterns it already
+  keeps. The phase ends when a block detects less than the given share
+  of the list, or when nothing is left to detect.
+-----------------------------------------------------------------------*/
+struct rng {
+	uint64_t s[4];
+};
+
+/*----------------- new function        ----------------------------------*/
+extern void rng_seed(struct rng *r, uint64_t seed);
+extern uint64_t rng_next(struct rng *r);
+extern int rpt(const CNET *c, uint64_t seed, double mingain, const int *flist,
+	int nf, int *detvec, struct pstore *ps);
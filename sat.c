@@ -0,0 +1,574 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sat.h"
+
+#define LVAL(s, l) ((s)->val[SVAR(l)] == 2 ? 2 : (s)->val[SVAR(l)] ^ ((l) & 1))
+
+/*----------------------------- VSIDS heap -----------------------------*/
+static void hswap(struct sat *s, int a, int b)
+{
+	int t = s->heap[a];
+	s->heap[a] = s->heap[b];
+	s->heap[b] = t;
+	s->hpos[s->heap[a]] = a;
+	s->hpos[s->heap[b]] = b;
+}
+
+static void hup(struct sat *s, int k)
+{
+	while(k > 0 && s->act[s->heap[(k - 1) / 2]] < s->act[s->heap[k]]){
+		hswap(s, k, (k - 1) / 2);
+		k = (k - 1) / 2;
+	}
+}
+
+static void hdown(struct sat *s, int k)
+{
+	int m;
+	for(;;){
+		m = k;
+		if(2 * k + 1 < s->nheap && s->act[s->heap[2 * k + 1]] > s->act[s->heap[m]]) m = 2 * k + 1;
+		if(2 * k + 2 < s->nheap && s->act[s->heap[2 * k + 2]] > s->act[s->heap[m]]) m = 2 * k + 2;
+		if(m == k) return;
+		hswap(s, k, m);
+		k = m;
+	}
+}
+
+static void hins(struct sat *s, int v)
+{
+	if(s->hpos[v] >= 0) return;
+	s->heap[s->nheap] = v;
+	s->hpos[v] = s->nheap++;
+	hup(s, s->nheap - 1);
+}
+
+static int hpop(struct sat *s)
+{
+	int v = s->heap[0];
+	hswap(s, 0, --s->nheap);
+	s->hpos[v] = -1;
+	if(s->nheap) hdown(s, 0);
+	return v;
+}
+
+static void bump(struct sat *s, int v)
+{
+	int i;
+	if((s->act[v] += s->inc) > 1e100){
+		for(i = 0; i < s->nv; i++) s->act[i] *= 1e-100;
+		s->inc *= 1e-100;
+	}
+	if(s->hpos[v] >= 0) hup(s, s->hpos[v]);
+}
+
+/*----------------------------- clauses --------------------------------*/
+static void watch(struct sat *s, int l, struct sclause *c, int blk)
+{
+	struct swlist *w = &s->wl[l];
+	if(w->n == w->cap){
+		w->cap = w->cap ? 2 * w->cap : 4;
+		w->w = (struct swatch *) realloc(w->w, w->cap * sizeof(struct swatch));
+	}
+	w->w[w->n].c = c;
+	w->w[w->n++].blk = blk;
+}
+
+static struct sclause *mkclause(struct sat *s, const int *lit, int n, int lbd)
+{
+	struct sclause *c = (struct sclause *) malloc(sizeof(struct sclause) + n * sizeof(int));
+	c->n = n;
+	c->lbd = lbd;
+	memcpy(c->lit, lit, n * sizeof(int));
+	watch(s, lit[0], c, lit[1]);
+	watch(s, lit[1], c, lit[0]);
+	if(lbd){
+		if(s->nlrn == s->lrncap){
+			s->lrncap = s->lrncap ? 2 * s->lrncap : 256;
+			s->lrn = (struct sclause **) realloc(s->lrn, s->lrncap * sizeof(*s->lrn));
+		}
+		s->lrn[s->nlrn++] = c;
+	}
+	else{
+		if(s->ncl == s->clcap){
+			s->clcap = s->clcap ? 2 * s->clcap : 256;
+			s->cl = (struct sclause **) realloc(s->cl, s->clcap * sizeof(*s->cl));
+		}
+		s->cl[s->ncl++] = c;
+	}
+	return c;
+}
+
+static void enqueue(struct sat *s, int l, struct sclause *from)
+{
+	int v = SVAR(l);
+	s->val[v] = !(l & 1);
+	s->level[v] = s->nlim;
+	s->reason[v] = from;
+	s->trail[s->ntrail++] = l;
+}
+
+static void cancel(struct sat *s, int lev)
+{
+	int k, v;
+	if(s->nlim <= lev) return;
+	for(k = s->ntrail - 1; k >= s->lim[lev]; k--){
+		v = SVAR(s->trail[k]);
+		s->phase[v] = s->val[v];
+		s->val[v] = 2;
+		s->reason[v] = NULL;
+		hins(s, v);
+	}
+	s->ntrail = s->qhead = s->lim[lev];
+	s->nlim = lev;
+}
+
+void sat_init(struct sat *s)
+{
+	memset(s, 0, sizeof(*s));
+	s->inc = 1;
+	s->ok = 1;
+	s->maxlrn = 2000;
+}
+
+void sat_free(struct sat *s)
+{
+	int i;
+	for(i = 0; i < s->ncl; i++) free(s->cl[i]);
+	for(i = 0; i < s->nlrn; i++) free(s->lrn[i]);
+	for(i = 0; i < 2 * s->nv; i++) free(s->wl[i].w);
+	free(s->cl);
+	free(s->lrn);
+	free(s->wl);
+	free(s->val);
+	free(s->phase);
+	free(s->model);
+	free(s->seen);
+	free(s->level);
+	free(s->reason);
+	free(s->act);
+	free(s->heap);
+	free(s->hpos);
+	free(s->trail);
+	free(s->lim);
+	free(s->buf);
+	free(s->lstamp);
+	free(s->freev);
+}
+
+/* a new variable, unassigned and with the saved phase 0; a released one
+   is handed out again first */
+int sat_newvar(struct sat *s)
+{
+	int v;
+	if(s->nfree){
+		v = s->freev[--s->nfree];
+		s->val[v] = 2;
+		s->phase[v] = 0;
+		s->act[v] = 0;
+		s->wl[2 * v].n = s->wl[2 * v + 1].n = 0;
+		if(s->hpos[v] >= 0) hdown(s, s->hpos[v]);
+		else hins(s, v);
+		return v;
+	}
+	v = s->nv++;
+	if(s->nv > s->vcap){
+		s->vcap = s->vcap ? 2 * s->vcap : 1024;
+#define GROW(p, n) p = realloc(p, (n) * sizeof(*(p)))
+		GROW(s->val, s->vcap);
+		GROW(s->phase, s->vcap);
+		GROW(s->model, s->vcap);
+		GROW(s->seen, s->vcap);
+		GROW(s->level, s->vcap);
+		GROW(s->reason, s->vcap);
+		GROW(s->act, s->vcap);
+		GROW(s->heap, s->vcap);
+		GROW(s->hpos, s->vcap);
+		GROW(s->trail, s->vcap);
+		GROW(s->lim, s->vcap + 1);
+		GROW(s->lstamp, s->vcap + 1);
+		GROW(s->buf, s->vcap + 1);
+		GROW(s->freev, s->vcap);
+#undef GROW
+		s->wl = (struct swlist *) realloc(s->wl, 2 * s->vcap * sizeof(struct swlist));
+	}
+	s->val[v] = 2;
+	s->phase[v] = 0;
+	s->model[v] = 0;
+	s->seen[v] = 0;
+	s->level[v] = 0;
+	s->reason[v] = NULL;
+	s->act[v] = 0;
+	s->lstamp[v] = 0;
+	s->hpos[v] = -1;
+	memset(s->wl + 2 * v, 0, 2 * sizeof(struct swlist));
+	hins(s, v);
+	return v;
+}
+
+/*-----------------------------------------------------------------------
+input: watched literal lists, trail with unpropagated literals
+output: a conflicting clause, or NULL
+called by: sat_add, sat_solve
+description: for each literal made true, visit the clauses watching its
+  negation: a clause with a true blocker or first watch is skipped,
+  otherwise a new non-false watch is looked for, and failing that the
+  other watch is implied or the clause is in conflict.
+author: Li
+-----------------------------------------------------------------------*/
+static struct sclause *propagate(struct sat *s)
+{
+	struct swlist *ws;
+	struct swatch *i, *j, *e;
+	struct sclause *c;
+	int fl, first, k;
+
+	while(s->qhead < s->ntrail){
+		fl = SNEG(s->trail[s->qhead++]);
+		s->props++;
+		ws = &s->wl[fl];
+		for(i = j = ws->w, e = ws->w + ws->n; i < e;){
+			if(LVAL(s, i->blk) == 1){
+				*j++ = *i++;
+				continue;
+			}
+			c = i->c;
+			if(c->lit[0] == fl){
+				c->lit[0] = c->lit[1];
+				c->lit[1] = fl;
+			}
+			i++;
+			first = c->lit[0];
+			if(LVAL(s, first) == 1){
+				j->c = c;
+				j++->blk = first;
+				continue;
+			}
+			for(k = 2; k < c->n; k++)
+				if(LVAL(s, c->lit[k]) != 0){
+					c->lit[1] = c->lit[k];
+					c->lit[k] = fl;
+					watch(s, c->lit[1], c, first);
+					break;
+				}
+			if(k < c->n) continue;
+			j->c = c;
+			j++->blk = first;
+			if(LVAL(s, first) == 0){
+				while(i < e) *j++ = *i++;
+				ws->n = j - ws->w;
+				s->qhead = s->ntrail;
+				return c;
+			}
+			enqueue(s, first, c);
+		}
+		ws->n = j - ws->w;
+	}
+	return NULL;
+}
+
+/* 1 if literal l of the learned clause is implied by the other ones */
+static int redundant(struct sat *s, int l)
+{
+	struct sclause *r = s->reason[SVAR(l)];
+	int k, v;
+	if(r == NULL) return 0;
+	for(k = 1; k < r->n; k++){
+		v = SVAR(r->lit[k]);
+		if(!s->seen[v] && s->level[v] > 0) return 0;
+	}
+	return 1;
+}
+
+/*-----------------------------------------------------------------------
+input: conflicting clause
+output: learned clause in buf (asserting literal first, a literal of
+  the backjump level second), its size, the backjump level in *bt and
+  its LBD in *lbd
+called by: sat_solve
+description: resolve the conflict back along the trail until one
+  literal of the current level is left (the first UIP), then drop the
+  literals whose reason is covered by the others.
+author: Li
+-----------------------------------------------------------------------*/
+static int analyze(struct sat *s, struct sclause *confl, int *bt, int *lbd)
+{
+	int *out = s->buf;
+	int n = 1, path = 0, p = -1, idx = s->ntrail - 1;
+	int k, q, v, m, max;
+
+	do{
+		for(k = p < 0 ? 0 : 1; k < confl->n; k++){
+			q = confl->lit[k];
+			v = SVAR(q);
+			if(s->seen[v] || s->level[v] == 0) continue;
+			bump(s, v);
+			s->seen[v] = 1;
+			if(s->level[v] >= s->nlim) path++;
+			else out[n++] = q;
+		}
+		while(!s->seen[SVAR(s->trail[idx--])]);
+		p = s->trail[idx + 1];
+		confl = s->reason[SVAR(p)];
+		s->seen[SVAR(p)] = 0;
+		path--;
+	}while(path > 0);
+	out[0] = SNEG(p);
+
+	/* swap, not copy: the dropped literals still need their marks cleared */
+	for(k = m = 1; k < n; k++)
+		if(!redundant(s, out[k])){
+			q = out[m];
+			out[m++] = out[k];
+			out[k] = q;
+		}
+	for(k = 1; k < n; k++) s->seen[SVAR(out[k])] = 0;
+	n = m;
+
+	*bt = 0;
+	for(k = 1, max = 1; k < n; k++)
+		if(s->level[SVAR(out[k])] > *bt){
+			*bt = s->level[SVAR(out[k])];
+			max = k;
+		}
+	if(n > 1){
+		q = out[1];
+		out[1] = out[max];
+		out[max] = q;
+	}
+	s->epoch++;
+	for(k = *lbd = 0; k < n; k++)
+		if(s->lstamp[s->level[SVAR(out[k])]] != s->epoch){
+			s->lstamp[s->level[SVAR(out[k])]] = s->epoch;
+			++*lbd;
+		}
+	return n;
+}
+
+static int bylbd(const void *a, const void *b)
+{
+	const struct sclause *x = *(struct sclause * const *) a;
+	const struct sclause *y = *(struct sclause * const *) b;
+	if(x->lbd != y->lbd) return y->lbd - x->lbd;
+	return y->n - x->n;
+}
+
+/* drop satisfied clauses and false literals from list, 0 for the deleted */
+static int sweep(struct sat *s, struct sclause **cl, int n)
+{
+	struct sclause *c;
+	int i, j, k, m;
+	for(i = j = 0; i < n; i++){
+		c = cl[i];
+		for(k = m = 0; k < c->n; k++){
+			if(LVAL(s, c->lit[k]) == 1) break;
+			if(LVAL(s, c->lit[k]) == 2) c->lit[m++] = c->lit[k];
+		}
+		if(k < c->n){
+			free(c);
+			continue;
+		}
+		c->n = m;
+		cl[j++] = c;
+	}
+	return j;
+}
+
+/*-----------------------------------------------------------------------
+input: solver at level 0 with everything propagated
+output: nothing
+called by: sat_simplify, sat_solve
+description: garbage collection. Satisfied clauses go, false literals
+  are cut out of the rest, and if there are too many learned clauses the
+  worse half by LBD goes too, keeping those of LBD 2 or less. The watch
+  lists are then built again from scratch, which is safe at level 0
+  since every literal left is unassigned.
+author: Li
+-----------------------------------------------------------------------*/
+static void collect(struct sat *s)
+{
+	int i, j, k;
+	for(i = 0; i < s->ntrail; i++) s->reason[SVAR(s->trail[i])] = NULL;
+	s->ncl = sweep(s, s->cl, s->ncl);
+	s->nlrn = sweep(s, s->lrn, s->nlrn);
+	if(s->nlrn >= s->maxlrn){
+		qsort(s->lrn, s->nlrn, sizeof(*s->lrn), bylbd);
+		for(i = j = 0; i < s->nlrn; i++){
+			if(i < s->nlrn / 2 && s->lrn[i]->lbd > 2) free(s->lrn[i]);
+			else s->lrn[j++] = s->lrn[i];
+		}
+		s->nlrn = j;
+		s->maxlrn *= 1.1;
+	}
+	for(i = 0; i < 2 * s->nv; i++) s->wl[i].n = 0;
+	for(k = 0; k < 2; k++){
+		struct sclause **cl = k ? s->lrn : s->cl;
+		int n = k ? s->nlrn : s->ncl;
+		for(i = 0; i < n; i++){
+			watch(s, cl[i]->lit[0], cl[i], cl[i]->lit[1]);
+			watch(s, cl[i]->lit[1], cl[i], cl[i]->lit[0]);
+		}
+	}
+}
+
+/*-----------------------------------------------------------------------
+input: literals and their count
+output: 0 if the clauses became unsatisfiable, 1 otherwise
+called by: the encoders
+description: add a problem clause. Only legal at level 0, which is
+  where sat_solve always returns. Literals false at level 0 are left
+  out, and a clause true at level 0 or holding a literal and its
+  negation is not stored at all.
+author: Li
+-----------------------------------------------------------------------*/
+int sat_add(struct sat *s, const int *lit, int n)
+{
+	int *b = s->buf;
+	int i, k, m = 0;
+
+	if(!s->ok) return 0;
+	for(i = 0; i < n; i++){
+		if(LVAL(s, lit[i]) == 1) return 1;
+		if(LVAL(s, lit[i]) == 0) continue;
+		for(k = 0; k < m && b[k] != lit[i]; k++)
+			if(b[k] == SNEG(lit[i])) return 1;
+		if(k == m) b[m++] = lit[i];
+	}
+	if(m == 0) return s->ok = 0;
+	if(m == 1){
+		enqueue(s, b[0], NULL);
+		return s->ok = propagate(s) == NULL;
+	}
+	mkclause(s, b, m, 0);
+	return 1;
+}
+
+/* propagate the level 0 units and collect the garbage they made */
+void sat_simplify(struct sat *s)
+{
+	if(!s->ok) return;
+	cancel(s, 0);
+	if(propagate(s)){
+		s->ok = 0;
+		return;
+	}
+	collect(s);
+}
+
+/*-----------------------------------------------------------------------
+input: variable assigned at level 0
+output: nothing
+called by: satpg
+description: after sat_simplify a variable fixed at level 0 is in no
+  clause any more (collect drops the satisfied clauses and the false
+  literals), so it can be taken off the trail and given out again by
+  sat_newvar instead of growing every per-variable array.
+author: Li
+-----------------------------------------------------------------------*/
+void sat_release(struct sat *s, int v)
+{
+	int k;
+	if(!s->ok || s->nlim || s->val[v] == 2) return;
+	for(k = 0; k < s->ntrail && SVAR(s->trail[k]) != v; k++);
+	if(k == s->ntrail) return;
+	memmove(s->trail + k, s->trail + k + 1, (s->ntrail - k - 1) * sizeof(int));
+	s->ntrail--;
+	if(s->qhead > k) s->qhead--;
+	s->reason[v] = NULL;
+	s->freev[s->nfree++] = v;
+}
+
+/* the Luby restart sequence 1 1 2 1 1 2 4 ... */
+static long luby(int i)
+{
+	long size, seq;
+	for(size = 1, seq = 0; size < i + 1; seq++) size = 2 * size + 1;
+	while(size - 1 != i){
+		size = (size - 1) >> 1;
+		seq--;
+		i = i % size;
+	}
+	return 1L << seq;
+}
+
+/*-----------------------------------------------------------------------
+input: assumption literals, conflict and time budget (0 for no time
+  limit)
+output: SAT_TRUE with the assignment in model, SAT_FALSE if there is no
+  assignment with all the assumptions true, SAT_UNDEF if the budget ran
+  out. The solver is back at level 0 in every case.
+called by: satpg
+description: CDCL search. The assumptions are decided first, one level
+  each; finding one false ends the search.
+author: Li
+-----------------------------------------------------------------------*/
+int sat_solve(struct sat *s, const int *as, int na, long maxconf, double maxsec)
+{
+	clock_t start = clock();
+	struct sclause *confl, *c;
+	long nconf = 0, rlim;
+	int restart = 0, n, bt, lbd, next, v;
+
+	if(!s->ok) return SAT_FALSE;
+	for(;;){
+		rlim = nconf + 100 * luby(restart++);
+		for(;;){
+			if((confl = propagate(s)) != NULL){
+				s->conflicts++;
+				nconf++;
+				if(s->nlim == 0){
+					s->ok = 0;
+					return SAT_FALSE;
+				}
+				n = analyze(s, confl, &bt, &lbd);
+				cancel(s, bt);
+				if(n == 1) enqueue(s, s->buf[0], NULL);
+				else{
+					c = mkclause(s, s->buf, n, lbd);
+					enqueue(s, s->buf[0], c);
+				}
+				s->inc *= 1 / 0.95;
+				if(nconf >= maxconf || (maxsec > 0 && (nconf & 63) == 0
+					&& (double) (clock() - start) / CLOCKS_PER_SEC > maxsec)){
+					cancel(s, 0);
+					return SAT_UNDEF;
+				}
+				continue;
+			}
+			if(nconf >= rlim) break;
+			next = -1;
+			while(s->nlim < na){
+				if(LVAL(s, as[s->nlim]) == 1) s->lim[s->nlim++] = s->ntrail;
+				else if(LVAL(s, as[s->nlim]) == 0){
+					cancel(s, 0);
+					return SAT_FALSE;
+				}
+				else{
+					next = as[s->nlim];
+					break;
+				}
+			}
+			while(next < 0 && s->nheap){
+				v = hpop(s);
+				if(s->val[v] == 2) next = SLIT(v, s->phase[v]);
+			}
+			if(next < 0){
+				memcpy(s->model, s->val, s->nv);
+				cancel(s, 0);
+				return SAT_TRUE;
+			}
+			s->decisions++;
+			s->lim[s->nlim++] = s->ntrail;
+			enqueue(s, next, NULL);
+		}
+		cancel(s, 0);
+		if(s->nlrn >= s->maxlrn) collect(s);
+	}
+}
@@ -0,0 +1,74 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+/*-----------------------------------------------------------------------
+  CDCL SAT solver
+
+  Variables are 0..nv-1, literal 2*v is v and 2*v+1 is not v. Clauses
+  are watched on their first two literals, conflicts are analysed to the
+  first UIP, decisions follow VSIDS activity with phase saving, and the
+  search restarts on the Luby sequence. sat_solve takes assumptions,
+  decided before anything else, so a caller can switch groups of clauses
+  on and off with selector variables while every learned clause stays.
+  Clause garbage (satisfied clauses and learned clauses of high LBD) is
+  only collected at level 0, at restarts and in sat_simplify. A selector
+  fixed at level 0 is in no clause after sat_simplify, and sat_release
+  hands it back for sat_newvar to reuse.
+-----------------------------------------------------------------------*/
+#define SLIT(v, b) (2 * (v) + !(b))     /* literal "v is b" */
+#define SVAR(l) ((l) >> 1)
+#define SNEG(l) ((l) ^ 1)
+
+enum e_sres {SAT_FALSE, SAT_TRUE, SAT_UNDEF};
+
+struct sclause {
+	int n;
+	int lbd;                /* literal block distance, 0 if not learned */
+	int lit[];
+};
+
+struct swatch {
+	struct sclause *c;
+	int blk;                /* a literal of c, if true c is satisfied */
+};
+
+struct swlist {
+	struct swatch *w;
+	int n, cap;
+};
+
+struct sat {
+	int nv, vcap;
+	unsigned char *val;     /* 0, 1, or 2 if unassigned */
+	unsigned char *phase;   /* saved value */
+	unsigned char *model;   /* values of the last SAT answer */
+	unsigned char *seen;
+	int *level;
+	struct sclause **reason;
+	double *act, inc;       /* VSIDS */
+	int *heap, *hpos, nheap;
+	struct swlist *wl;      /* clauses watching each literal */
+	int *trail, ntrail, qhead;
+	int *lim, nlim;         /* trail size at the start of each level */
+	struct sclause **cl;    /* problem clauses */
+	int ncl, clcap;
+	struct sclause **lrn;   /* learned clauses */
+	int nlrn, lrncap;
+	double maxlrn;
+	int *buf, bufcap;
+	int *lstamp, epoch;     /* LBD marks per level */
+	int *freev, nfree;      /* released variables, sat_newvar reuses them */
+	int ok;                 /* 0 once the clauses are unsatisfiable */
+	long conflicts, decisions, props;
+};
+
+/*----------------- new function        ----------------------------------*/
+extern void sat_init(struct sat *s);
+extern void sat_free(struct sat *s);
+extern int sat_newvar(struct sat *s);
+extern int sat_add(struct sat *s, const int *lit, int n);
+extern int sat_solve(struct sat *s, const int *as, int na, long maxconf, double maxsec);
+extern void sat_simplify(struct sat *s);
+extern void sat_release(struct sat *s, int v);
@@ -0,0 +1,211 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "type.h"
+#include "netlist.h"
+#include "evsim.h"
+#include "atpg.h"
+#include "sat.h"
+#include "satpg.h"
+
+/* add the n literals in buf, plus the guard literal if there is one */
+static void put(struct satpg *p, int n, int guard)
+{
+	if(guard >= 0) p->buf[n++] = guard;
+	sat_add(&p->s, p->buf, n);
+}
+
+/* y = a xor b */
+static void xor2(struct satpg *p, int y, int a, int b, int guard)
+{
+	int k;
+	for(k = 0; k < 4; k++){
+		p->buf[0] = SLIT(y, k >> 1);
+		p->buf[1] = SLIT(a, (k >> 1) ^ (k & 1));
+		p->buf[2] = SLIT(b, k & 1);
+		put(p, 3, guard);
+	}
+}
+
+/*-----------------------------------------------------------------------
+input: state, node, variable offset (0 for the good circuit, nbase for
+  the faulty copy), guard literal or -1
+output: nothing
+called by: satpg_init, satpg
+description: Tseitin clauses of gate i. In the faulty copy the fan-ins
+  outside the fault cone use the good variables.
+author: Li
+-----------------------------------------------------------------------*/
+static void gate(struct satpg *p, int i, int off, int guard)
+{
+	const CNET *c = p->c;
+	int t = c->type[i], y = off + i, n = c->fioff[i + 1] - c->fioff[i];
+	int k, x, yl, prev;
+#define IN(k) (off && p->tfo[c->fi[c->fioff[i] + (k)]] ? off : 0) + c->fi[c->fioff[i] + (k)]
+
+	if(t == IPT) return;
+	if(t == BRCH || t == NOT || (t == XOR && n == 1)){
+		x = IN(0);
+		p->buf[0] = SLIT(y, 1);
+		p->buf[1] = SLIT(x, t == NOT);
+		put(p, 2, guard);
+		p->buf[0] = SLIT(y, 0);
+		p->buf[1] = SLIT(x, t != NOT);
+		put(p, 2, guard);
+		return;
+	}
+	if(t == XOR){
+		for(prev = IN(0), k = 1; k < n; k++){
+			x = k == n - 1 ? y : off + p->aux[i] + k - 1;
+			xor2(p, x, prev, IN(k), guard);
+			prev = x;
+		}
+		return;
+	}
+	/* AND/NAND: y core 1 iff all inputs 1, OR/NOR: y core 0 iff all 0 */
+	if(t == AND || t == NAND){
+		yl = SLIT(y, t == AND);
+		for(k = 0; k < n; k++){
+			p->buf[0] = SNEG(yl);
+			p->buf[1] = SLIT(IN(k), 1);
+			put(p, 2, guard);
+		}
+		for(p->buf[0] = yl, k = 0; k < n; k++) p->buf[k + 1] = SLIT(IN(k), 0);
+	}
+	else{
+		yl = SLIT(y, t == OR);
+		for(k = 0; k < n; k++){
+			p->buf[0] = yl;
+			p->buf[1] = SLIT(IN(k), 0);
+			put(p, 2, guard);
+		}
+		for(p->buf[0] = SNEG(yl), k = 0; k < n; k++) p->buf[k + 1] = SLIT(IN(k), 1);
+	}
+	put(p, n + 1, guard);
+#undef IN
+}
+
+/*-----------------------------------------------------------------------
+input: state, circuit, conflict limit and time limit per fault
+output: nothing
+called by: satS
+description: lay out the variables (good nodes, XOR chains, the same
+  again for the faulty copy, one miter variable per PO) and encode the
+  good circuit.
+author: Li
+-----------------------------------------------------------------------*/
+void satpg_init(struct satpg *p, const CNET *c, long maxbt, double maxsec)
+{
+	int i, n, nv, maxfi = 2;
+
+	memset(p, 0, sizeof(*p));
+	p->c = c;
+	p->maxbt = maxbt;
+	p->maxsec = maxsec;
+	p->aux = (int *) malloc(c->n * sizeof(int));
+	p->po = (int *) malloc(c->n * sizeof(int));
+	p->tfo = (unsigned char *) calloc(c->n, 1);
+	p->need = (unsigned char *) calloc(c->n, 1);
+	for(nv = c->n, i = 0; i < c->n; i++){
+		n = c->fioff[i + 1] - c->fioff[i];
+		if(n > maxfi) maxfi = n;
+		p->aux[i] = nv;
+		if(c->type[i] == XOR && n > 2) nv += n - 2;
+	}
+	p->nbase = nv;
+	p->buf = (int *) malloc((maxfi + 2) * sizeof(int));
+	memset(p->po, -1, c->n * sizeof(int));
+	for(i = c->npo - 1; i >= 0; i--) p->po[c->po[i]] = i;
+	sat_init(&p->s);
+	for(i = 0; i < 2 * nv + c->npo; i++) sat_newvar(&p->s);
+	for(i = 0; i < c->n; i++) gate(p, i, 0, -1);
+}
+
+void satpg_free(struct satpg *p)
+{
+	sat_free(&p->s);
+	free(p->aux);
+	free(p->po);
+	free(p->tfo);
+	free(p->need);
+	free(p->buf);
+}
+
+/*-----------------------------------------------------------------------
+input: state, FArr fault id, room for a vector of npi values
+output: T_DETECTED with the test cube in vec, T_REDUNDANT if the miter is
+  unsatisfiable, T_ABORTED at the conflict or time limit
+called by: satgen
+description: SAT-based ATPG for one fault.
+author: Li
+-----------------------------------------------------------------------*/
+int satpg(struct satpg *p, int f, int *vec)
+{
+	const CNET *c = p->c;
+	int site = f / 2, sv = f % 2, nb = p->nbase;
+	int i, k, d, sel, guard, np = 0, r;
+	long conf = p->s.conflicts;
+
+	memset(p->tfo, 0, c->n);
+	p->tfo[site] = 1;
+	for(i = site; i < c->n; i++)
+		if(p->tfo[i])
+			for(k = c->fooff[i]; k < c->fooff[i + 1]; k++) p->tfo[c->fo[k]] = 1;
+	sel = sat_newvar(&p->s);
+	guard = SLIT(sel, 0);
+
+	/* faulty cone: the site is stuck, the good site has the other value */
+	p->buf[0] = SLIT(nb + site, sv);
+	put(p, 1, guard);
+	p->buf[0] = SLIT(site, !sv);
+	put(p, 1, guard);
+	for(i = site + 1; i < c->n; i++)
+		if(p->tfo[i]) gate(p, i, nb, guard);
+
+	/* miter: d_k only if PO k differs, and some d_k of the cone */
+	for(i = site; i < c->n; i++){
+		if(!p->tfo[i] || p->po[i] < 0) continue;
+		d = 2 * nb + p->po[i];
+		for(k = 0; k < 2; k++){
+			p->buf[0] = SLIT(d, 0);
+			p->buf[1] = SLIT(i, k);
+			p->buf[2] = SLIT(nb + i, k);
+			put(p, 3, guard);
+		}
+		np++;
+	}
+	if(np){
+		int *lit = (int *) malloc((np + 1) * sizeof(int));
+		for(np = 0, i = site; i < c->n; i++)
+			if(p->tfo[i] && p->po[i] >= 0) lit[np++] = SLIT(2 * nb + p->po[i], 1);
+		lit[np++] = guard;
+		sat_add(&p->s, lit, np);
+		free(lit);
+		k = SLIT(sel, 1);
+		r = sat_solve(&p->s, &k, 1, p->maxbt, p->maxsec);
+	}
+	else r = SAT_FALSE;
+	p->bt = p->s.conflicts - conf;
+	if(r == SAT_TRUE){
+		/* PIs that reach no PO of the cone are left X */
+		for(i = c->n - 1; i >= 0; i--){
+			p->need[i] = p->tfo[i] && p->po[i] >= 0;
+			for(k = c->fooff[i]; k < c->fooff[i + 1] && !p->need[i]; k++)
+				p->need[i] = p->need[c->fo[k]];
+		}
+		for(k = 0; k < c->npi; k++)
+			vec[k] = p->need[c->pi[k]] ? p->s.model[c->pi[k]] : 2;
+	}
+
+	/* switch the fault off for good, its clauses are collected and the
+	   selector is free for the next fault */
+	sat_add(&p->s, &guard, 1);
+	sat_simplify(&p->s);
+	sat_release(&p->s, sel);
+	return r == SAT_TRUE ? T_DETECTED : r == SAT_FALSE ? T_REDUNDANT : T_ABORTED;
+}
@@ -0,0 +1,38 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+/*-----------------------------------------------------------------------
+  SAT-based test generation
+
+  The good circuit is encoded once: variable i is compiled node i, with
+  a chain of extra variables for XOR gates of more than two inputs. For
+  each fault a faulty copy of the fan-out cone of the site is added (a
+  node outside the cone shares the good variable), plus a miter that
+  wants some PO of the cone to differ. These clauses all carry the
+  negation of a selector variable, which is assumed true while the
+  fault is solved and set false afterwards; once its clauses are
+  collected the selector is released and the next fault gets it again.
+  The faulty and miter variables are reused by the next fault too,
+  while clauses learned from the good circuit alone stay useful for
+  every later fault.
+-----------------------------------------------------------------------*/
+struct satpg {
+	const CNET *c;
+	struct sat s;
+	int *aux;               /* first XOR chain variable of each node */
+	int nbase;              /* variables of the good circuit */
+	int *po;                /* PO index of each node, -1 if none */
+	unsigned char *tfo;     /* fan-out cone of the current fault */
+	unsigned char *need;    /* fan-in cone of the POs in tfo */
+	int *buf;               /* literals of the clause being built */
+	long maxbt;             /* conflict limit per fault */
+	double maxsec;          /* time limit per fault, 0 for none */
+	long bt;                /* conflicts of the last fault */
+};
+
+/*----------------- new function        ----------------------------------*/
+extern void satpg_init(struct satpg *p, const CNET *c, long maxbt, double maxsec);
+extern void satpg_free(struct satpg *p);
+extern int satpg(struct satpg *p, int f, int *vec);
@@ -0,0 +1,126 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "type.h"
+#include "netlist.h"
+#include "scoap.h"
+
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#define ADD(a, b) MIN((a) + (b), SCOAP_INF)     /* both at most SCOAP_INF */
+
+/*-----------------------------------------------------------------------
+input: netlist, cc0 and cc1 with room for every node
+output: nothing
+called by: scoap
+description: combinational controllability in one level order pass.
+  An n-input XOR is folded two inputs at a time.
+author: Li
+-----------------------------------------------------------------------*/
+void scoap_cc(const CNET *c, int *cc0, int *cc1)
+{
+	int i, k, j, t, z0, z1, y0, y1;
+
+	for(i = 0; i < c->n; i++){
+		t = c->type[i];
+		if(t == IPT){
+			cc0[i] = cc1[i] = 1;
+			continue;
+		}
+		k = c->fioff[i];
+		j = c->fi[k];
+		if(t == BRCH){
+			cc0[i] = cc0[j];
+			cc1[i] = cc1[j];
+			continue;
+		}
+		z0 = cc0[j];
+		z1 = cc1[j];
+		for(k++; k < c->fioff[i + 1]; k++){
+			j = c->fi[k];
+			switch(t){
+				case AND:
+				case NAND:
+					z0 = MIN(z0, cc0[j]);
+					z1 = ADD(z1, cc1[j]);
+					break;
+				case OR:
+				case NOR:
+					z0 = ADD(z0, cc0[j]);
+					z1 = MIN(z1, cc1[j]);
+					break;
+				case XOR:
+					y0 = MIN(ADD(z0, cc0[j]), ADD(z1, cc1[j]));
+					y1 = MIN(ADD(z0, cc1[j]), ADD(z1, cc0[j]));
+					z0 = y0;
+					z1 = y1;
+					break;
+			}
+		}
+		if(t == NOT || t == NAND || t == NOR){
+			cc0[i] = ADD(z1, 1);
+			cc1[i] = ADD(z0, 1);
+		}
+		else{
+			cc0[i] = ADD(z0, 1);
+			cc1[i] = ADD(z1, 1);
+		}
+	}
+}
+
+/*-----------------------------------------------------------------------
+input: netlist, its controllability, co with room for every node
+output: nothing
+called by: scoap
+description: observability in one pass from the last node back. When
+  node i is reached all its fan-outs are done, so co[i] is final and is
+  handed to each fan-in: a branch passes it on, a NOT adds 1, other
+  gates add 1 plus what it costs to set every other input to its non-
+  controlling value (the cheaper value for XOR). The side cost is the
+  sum over all inputs less the input itself, so a gate costs O(fan-in).
+author: Li
+-----------------------------------------------------------------------*/
+void scoap_co(const CNET *c, const int *cc0, const int *cc1, int *co)
+{
+	int i, k, j, t, o;
+	long long sum, own;
+
+	for(i = 0; i < c->n; i++) co[i] = SCOAP_INF;
+	for(k = 0; k < c->npo; k++) co[c->po[k]] = 0;
+	for(i = c->n - 1; i >= 0; i--){
+		t = c->type[i];
+		if(t == IPT || co[i] == SCOAP_INF) continue;
+		for(sum = 0, k = c->fioff[i]; k < c->fioff[i + 1]; k++){
+			j = c->fi[k];
+			sum += t == AND || t == NAND ? cc1[j] : t == OR || t == NOR ? cc0[j]
+				: MIN(cc0[j], cc1[j]);
+		}
+		for(k = c->fioff[i]; k < c->fioff[i + 1]; k++){
+			j = c->fi[k];
+			if(t == BRCH) o = co[i];
+			else{
+				own = t == AND || t == NAND ? cc1[j] : t == OR || t == NOR ? cc0[j]
+					: MIN(cc0[j], cc1[j]);
+				if(t == NOT) own = sum;
+				o = (int) MIN((long long) co[i] + 1 + sum - own, (long long) SCOAP_INF);
+			}
+			co[j] = MIN(co[j], o);
+		}
+	}
+}
+
+/* compute the SCOAP columns of the netlist */
+void scoap(CNET *c)
+{
+	free(c->cc0);
+	free(c->cc1);
+	free(c->co);
+	c->cc0 = (int *) malloc((c->n + 1) * sizeof(int));
+	c->cc1 = (int *) malloc((c->n + 1) * sizeof(int));
+	c->co = (int *) malloc((c->n + 1) * sizeof(int));
+	scoap_cc(c, c->cc0, c->cc1);
+	scoap_co(c, c->cc0, c->cc1, c->co);
+}
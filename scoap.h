@@ -0,0 +1,23 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+/*-----------------------------------------------------------------------
+  SCOAP testability measures
+
+  cc0[i]/cc1[i] estimate how hard it is to set compiled node i to 0/1
+  from the primary inputs (a PI costs 1, each gate adds 1, a fan-out
+  branch adds nothing), co[i] how hard it is to see node i at a PO (a PO
+  costs 0, each gate adds 1 plus the cost of setting its other inputs).
+  Each is one pass over the nodes in index order, forward for CC and
+  backward for CO, and saturates at SCOAP_INF, the value of a line that
+  cannot be controlled or observed. scoap() keeps the three columns in
+  the netlist, where the ATPG engines and the .ckb image find them.
+-----------------------------------------------------------------------*/
+#define SCOAP_INF 0x3fffffff
+
+/*----------------- new function        ----------------------------------*/
+extern void scoap_cc(const CNET *c, int *cc0, int *cc1);
+extern void scoap_co(const CNET *c, const int *cc0, const int *cc1, int *co);
+extern void scoap(CNET *c);
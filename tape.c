@@ -0,0 +1,154 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "type.h"
+#include "netlist.h"
+#include "tape.h"
+
+/* instruction kind of gate i, -1 if it has nothing to compute */
+static int gkind(const CNET *c, int i)
+{
+	int n = c->fioff[i + 1] - c->fioff[i], op;
+
+	if(n == 0) return -1;
+	switch(c->type[i]){
+		case BRCH: return TAPE_KIND(T_BUF, 1);
+		case NOT: return TAPE_KIND(T_INV, 1);
+		case AND: op = T_AND; break;
+		case NAND: op = T_NAND; break;
+		case OR: op = T_OR; break;
+		case NOR: op = T_NOR; break;
+		case XOR: op = T_XOR; break;
+		default: return -1;
+	}
+	if(n == 1) return TAPE_KIND(op == T_NAND || op == T_NOR ? T_INV : T_BUF, 1);
+	return TAPE_KIND(op, n > 4 ? 0 : n);
+}
+
+/*-----------------------------------------------------------------------
+input: compiled netlist
+output: its instruction tape
+called by: cread, tapeS
+description: level by level, one pass over the gates of the level per
+  kind, so each level is cut into at most TAPE_NKIND runs. The gates of
+  one level do not feed each other and may run in any order.
+author: Li
+-----------------------------------------------------------------------*/
+struct tape *tape_build(const CNET *c)
+{
+	struct tape *t = (struct tape *) calloc(1, sizeof(struct tape));
+	int *kind = (int *) malloc((c->n + 1) * sizeof(int));
+	int l, q, i, k, from;
+
+	t->slot = (int *) malloc((2 * c->n + c->nfi + 1) * sizeof(int));
+	t->run = (struct trun *) malloc((c->n + 1) * sizeof(struct trun));
+	for(i = 0; i < c->n; i++) kind[i] = gkind(c, i);
+	for(l = 1; l < c->nlev; l++)
+		for(q = 0; q < TAPE_NKIND; q++){
+			from = t->nslot;
+			for(i = c->levoff[l]; i < c->levoff[l + 1]; i++){
+				if(kind[i] != q) continue;
+				t->slot[t->nslot++] = i;
+				if(q % 5 == 0) t->slot[t->nslot++] = c->fioff[i + 1] - c->fioff[i];
+				for(k = c->fioff[i]; k < c->fioff[i + 1]; k++) t->slot[t->nslot++] = c->fi[k];
+			}
+			if(t->nslot == from) continue;
+			t->run[t->nrun].kind = q;
+			t->run[t->nrun].from = from;
+			t->run[t->nrun++].to = t->nslot;
+		}
+	free(kind);
+	return t;
+}
+
+void tape_free(struct tape *t)
+{
+	if(t == NULL) return;
+	free(t->run);
+	free(t->slot);
+	free(t);
+}
+
+/*-----------------------------------------------------------------------
+  one loop per kind; s walks the slots of the run up to e, v holds the
+  values and x is the scratch of the N input loops
+-----------------------------------------------------------------------*/
+#define ID(x) (x)
+#define BNEG(x) ((x) ^ 1)
+#define WNEG(x) (~(x))
+
+#define K1(f) for(; s < e; s += 2) v[s[0]] = f(v[s[1]])
+#define K2(op, f) for(; s < e; s += 3) v[s[0]] = f(v[s[1]] op v[s[2]])
+#define K3(op, f) for(; s < e; s += 4) v[s[0]] = f(v[s[1]] op v[s[2]] op v[s[3]])
+#define K4(op, f) for(; s < e; s += 5) \
+	v[s[0]] = f(v[s[1]] op v[s[2]] op v[s[3]] op v[s[4]])
+#define KN(op, f) for(; s < e; s += 2 + s[1]){ \
+		x = v[s[2]]; \
+		for(k = 3; k < 2 + s[1]; k++) x = x op v[s[k]]; \
+		v[s[0]] = f(x); \
+	}
+#define KOP(o, op, f) \
+	case TAPE_KIND(o, 2): K2(op, f); break; \
+	case TAPE_KIND(o, 3): K3(op, f); break; \
+	case TAPE_KIND(o, 4): K4(op, f); break; \
+	case TAPE_KIND(o, 0): KN(op, f); break;
+
+#define DEF_TAPE(name, W, NEG, attr) \
+attr static void name(const struct tape *t, W *v) \
+{ \
+	const int *s, *e; \
+	int r, k; \
+	W x; \
+	for(r = 0; r < t->nrun; r++){ \
+		s = t->slot + t->run[r].from; \
+		e = t->slot + t->run[r].to; \
+		switch(t->run[r].kind){ \
+			case TAPE_KIND(T_BUF, 1): K1(ID); break; \
+			case TAPE_KIND(T_INV, 1): K1(NEG); break; \
+			KOP(T_AND, &, ID) \
+			KOP(T_NAND, &, NEG) \
+			KOP(T_OR, |, ID) \
+			KOP(T_NOR, |, NEG) \
+			KOP(T_XOR, ^, ID) \
+		} \
+	} \
+}
+
+typedef uint64_t v4w __attribute__((vector_size(32)));
+typedef uint64_t v8w __attribute__((vector_size(64)));
+
+DEF_TAPE(texec0, unsigned char, BNEG, )
+DEF_TAPE(texec1, uint64_t, WNEG, )
+DEF_TAPE(texec4, v4w, WNEG, )
+DEF_TAPE(texec8, v8w, WNEG, )
+DEF_TAPE(texec4_avx2, v4w, WNEG, __attribute__((target("avx2"))))
+DEF_TAPE(texec8_avx512, v8w, WNEG, __attribute__((target("avx512f"))))
+
+/* cnet_sim on the tape, the PI values must already be in val */
+void tape_sim(const struct tape *t, unsigned char *val)
+{
+	texec0(t, val);
+}
+
+/* cnet_wsim on the tape, same layout of w */
+void tape_wsim(const struct tape *t, uint64_t *w, int lanes)
+{
+	int hw = cnet_lanes();
+	switch(lanes){
+		case 8:
+			if(hw >= 8) texec8_avx512(t, (v8w *) w);
+			else texec8(t, (v8w *) w);
+			break;
+		case 4:
+			if(hw >= 4) texec4_avx2(t, (v4w *) w);
+			else texec4(t, (v4w *) w);
+			break;
+		default:
+			texec1(t, w);
+	}
+}
@@ -0,0 +1,41 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+/*-----------------------------------------------------------------------
+  instruction tape
+
+  The netlist lowered to a flat list of instructions for the simulators.
+  An instruction is its output node followed by its fan-in nodes, all
+  as int slots in one array; gates of fan-in 5 and up also store the
+  count after the output. Within each level the gates are sorted by
+  kind, an opcode (buffer, inverter, AND, NAND, OR, NOR, XOR) together
+  with a fan-in class (1, 2, 3, 4 or N), and every stretch of one kind
+  is a run. A run is executed by a loop made for its kind, so the only
+  dispatch left is one switch per run, not per gate. The same loops are
+  instantiated for 0/1 bytes (tape_sim) and for 64*lanes bit words
+  (tape_wsim).
+-----------------------------------------------------------------------*/
+enum e_top {T_BUF, T_INV, T_AND, T_NAND, T_OR, T_NOR, T_XOR};
+
+#define TAPE_KIND(op, k) ((op) * 5 + (k))      /* k: fan-in 1..4, 0 for N */
+#define TAPE_NKIND 35
+
+struct trun {
+	int kind;
+	int from, to;           /* its slots */
+};
+
+struct tape {
+	int nrun;
+	struct trun *run;
+	int nslot;
+	int *slot;
+};
+
+/*----------------- new function        ----------------------------------*/
+extern struct tape *tape_build(const CNET *c);
+extern void tape_free(struct tape *t);
+extern void tape_sim(const struct tape *t, unsigned char *val);
+extern void tape_wsim(const struct tape *t, uint64_t *w, int lanes);
@@ -0,0 +1,293 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "type.h"
+#include "netlist.h"
+#include "evsim.h"
+#include "pstore.h"
+#include "fsim.h"
+#include "dfsim.h"
+#include "wspool.h"
+#include "tsim.h"
+
+/* one PPSFP worker, [lo,hi) of the fault list */
+struct twork {
+	const CNET *c;
+	const struct pstore *ps;
+	const int *flist;
+	int *detvec;
+	int lo, hi;
+	int nd;                 /* PPSFP faults detected */
+};
+
+/* thread count for n, 0 means one per online CPU */
+int tsim_nthreads(int n)
+{
+	long k;
+	if(n > 0) return n;
+	k = sysconf(_SC_NPROCESSORS_ONLN);
+	return k > 0 ? (int) k : 1;
+}
+
+/* load the value plane v of a vector into the 0/1 column val and trace
+   the changes */
+static void tsetvec(struct evq *q, unsigned char *val, const uint64_t *v)
+{
+	const CNET *c = q->c;
+	int k, i;
+	for(k = 0; k < c->npi; k++){
+		i = c->pi[k];
+		if(val[i] != PS_BIT(v, k)){
+			val[i] = PS_BIT(v, k);
+			evq_fanout(q, i);
+		}
+	}
+	ev_run(q, val);
+}
+
+/* per worker state of tsim_grade, set up by the worker on its first task */
+struct gwork {
+	unsigned char *val;     /* fault free values of the last vector */
+	struct evq q;
+	struct dfsim s;
+	uint64_t *pv, *pg, *andmk, *ormk;
+	uint64_t *skip;         /* faults known detected, the worker's copy */
+	uint64_t *seen;         /* faults the current vector detects */
+	int *act;               /* PFS faults to simulate */
+};
+
+struct gctx {
+	const CNET *c;
+	const struct pstore *ps;
+	int nvec;
+	int *right;
+	int pfs;
+	int chunk;              /* vectors per task */
+	int nw;                 /* words of a fault set */
+	_Atomic uint64_t *det;  /* faults detected by any worker */
+	struct gwork *w;
+};
+
+static void ginit(struct gctx *g, struct gwork *w)
+{
+	const CNET *c = g->c;
+	int i;
+	w->val = (unsigned char *) calloc(c->n, 1);
+	evq_init(&w->q, c);
+	cnet_sim(c, w->val);
+	w->skip = (uint64_t *) malloc(g->nw * sizeof(uint64_t));
+	w->seen = (uint64_t *) malloc(g->nw * sizeof(uint64_t));
+	if(!g->pfs){
+		dfsim_init(&w->s, c);
+		w->s.drop = w->skip;
+		return;
+	}
+	w->pv = cnet_walloc(c, 1);
+	w->pg = cnet_walloc(c, 1);
+	w->andmk = cnet_walloc(c, 1);
+	w->ormk = cnet_walloc(c, 1);
+	for(i = 0; i < c->n; i++) w->andmk[i] = ~0ULL;
+	w->act = (int *) malloc((2 * c->n + 1) * sizeof(int));
+}
+
+static void gfree(struct gctx *g, struct gwork *w)
+{
+	if(!w->val) return;
+	free(w->val);
+	evq_free(&w->q);
+	free(w->skip);
+	free(w->seen);
+	if(!g->pfs){
+		dfsim_free(&w->s);
+		return;
+	}
+	free(w->pv);
+	free(w->pg);
+	free(w->andmk);
+	free(w->ormk);
+	free(w->act);
+}
+
+/*-----------------------------------------------------------------------
+input: worker state, number of faults in act
+output: nothing, w->seen gets the faults of act the vector detects
+called by: gtask
+description: PFS of the current vector over an arbitrary list of FArr
+  ids, 64 faults per word.
+author: Li
+-----------------------------------------------------------------------*/
+static void gpfs(const CNET *c, struct gwork *w, int na)
+{
+	uint64_t d;
+	int i, j, k, s, f, hi;
+
+	for(i = 0; i < c->n; i++) w->pv[i] = w->pg[i] = w->val[i] ? ~0ULL : 0;
+	for(i = 0; i < na; i += 64){
+		hi = i + 64 < na ? i + 64 : na;
+		for(j = i; j < hi; j++){
+			s = w->act[j] / 2;
+			if(w->act[j] % 2 == 0) w->andmk[s] &= ~(1ULL << (j - i));
+			else w->ormk[s] |= 1ULL << (j - i);
+		}
+		for(j = i; j < hi; j++){
+			s = w->act[j] / 2;
+			ev_wset(&w->q, w->pv, s, (w->pv[s] & w->andmk[s]) | w->ormk[s]);
+		}
+		ev_wrun(&w->q, w->pv, w->pg, w->andmk, w->ormk, 0);
+		for(d = 0, k = 0; k < c->npo; k++) d |= w->pv[c->po[k]] ^ w->pg[c->po[k]];
+		for(j = i; j < hi; j++){
+			f = w->act[j];
+			if((d >> (j - i)) & 1) w->seen[f >> 6] |= 1ULL << (f & 63);
+			w->andmk[f / 2] = ~0ULL;
+			w->ormk[f / 2] = 0;
+		}
+		ev_wrestore(&w->q, w->pv, w->pg);
+	}
+}
+
+/*-----------------------------------------------------------------------
+input: grading context, worker, task
+output: nothing
+called by: wspool_run
+description: grade one chunk of vectors. The worker copies the shared
+  detection bitmap when the task starts and leaves those faults out,
+  except the target of the vector at hand, so right[] stays exact.
+  New detections go into the bitmap with an atomic or.
+author: Li
+-----------------------------------------------------------------------*/
+static void gtask(void *ctx, int id, int task)
+{
+	struct gctx *g = (struct gctx *) ctx;
+	struct gwork *w = &g->w[id];
+	const CNET *c = g->c;
+	const uint64_t *d;
+	uint64_t m, keep;
+	int v, hi, t, k, f, na;
+
+	if(!w->val) ginit(g, w);
+	for(k = 0; k < g->nw; k++)
+		w->skip[k] = atomic_load_explicit(&g->det[k], memory_order_relaxed);
+	hi = (task + 1) * g->chunk < g->nvec ? (task + 1) * g->chunk : g->nvec;
+	for(v = task * g->chunk; v < hi; v++){
+		t = g->ps->tgt[v];
+		keep = w->skip[t >> 6];
+		w->skip[t >> 6] &= ~(1ULL << (t & 63));
+		tsetvec(&w->q, w->val, PS_VAL(g->ps, v));
+		if(g->pfs){
+			memset(w->seen, 0, g->nw * sizeof(uint64_t));
+			for(na = 0, k = 0; k < g->nw; k++)
+				for(m = ~w->skip[k]; m; m &= m - 1){
+					f = k * 64 + __builtin_ctzll(m);
+					if(f >= 2 * c->n) break;
+					w->act[na++] = f;
+				}
+			gpfs(c, w, na);
+			d = w->seen;
+		}
+		else d = dfsim_run(&w->s, w->val);
+		g->right[v] = (d[t >> 6] >> (t & 63)) & 1;
+		w->skip[t >> 6] = keep;
+		for(k = 0; k < g->nw; k++)
+			if(d[k] & ~w->skip[k]){
+				atomic_fetch_or_explicit(&g->det[k], d[k], memory_order_relaxed);
+				w->skip[k] |= d[k];
+			}
+	}
+}
+
+/*-----------------------------------------------------------------------
+input: netlist, pattern store, 1 for PFS or 0 for DFS, thread count
+output: number of FArr faults detected by some vector; right[v] is 1
+  when vector v detects its target ps->tgt[v]; bit f of det (2*c->n bits)
+  is set when fault f is detected
+called by: DFS_client, PFS_client
+description: the vector list is cut into chunks that run as tasks on
+  the work-stealing pool of wspool.c. Faults detected by any worker are
+  dropped from the tasks that start later. Both results are the same
+  for every thread count and schedule.
+author: Li
+-----------------------------------------------------------------------*/
+int tsim_grade(const CNET *c, const struct pstore *ps, int *right, uint64_t *det, int pfs, int nthr)
+{
+	struct gctx g;
+	int k, t, nd = 0;
+
+	g.c = c;
+	g.ps = ps;
+	g.nvec = ps->n;
+	g.right = right;
+	g.pfs = pfs;
+	g.chunk = 8;
+	g.nw = (2 * c->n + 63) / 64;
+	g.det = (_Atomic uint64_t *) malloc(g.nw * sizeof(uint64_t));
+	for(k = 0; k < g.nw; k++) atomic_init(&g.det[k], 0);
+	g.w = (struct gwork *) calloc(nthr, sizeof(struct gwork));
+	wspool_run(nthr, (g.nvec + g.chunk - 1) / g.chunk, gtask, &g);
+	for(k = 0; k < g.nw; k++){
+		det[k] = atomic_load(&g.det[k]);
+		nd += __builtin_popcountll(det[k]);
+	}
+	for(t = 0; t < nthr; t++) gfree(&g, &g.w[t]);
+	free(g.w);
+	free((void *) g.det);
+	return nd;
+}
+
+static void *ppsfp_work(void *arg)
+{
+	struct twork *w = (struct twork *) arg;
+	w->nd = ppsfp(w->c, w->ps, w->flist + w->lo, w->hi - w->lo, w->detvec + w->lo);
+	return NULL;
+}
+
+/*-----------------------------------------------------------------------
+input: worker template, number of items to split, items per unit, thread
+  count, worker function
+output: nothing
+called by: tsim_ppsfp
+description: cut [0,n) into nthr contiguous ranges on unit boundaries,
+  run the first range in the calling thread and the rest in new threads,
+  then wait for all of them. w gets nthr entries.
+author: Li
+-----------------------------------------------------------------------*/
+static void trun(struct twork *w, int n, int unit, int nthr, void *(*fn)(void *))
+{
+	pthread_t *tid = (pthread_t *) malloc(nthr * sizeof(pthread_t));
+	int nu = (n + unit - 1) / unit;
+	int t, started = 0;
+
+	if(nthr > nu) nthr = nu > 0 ? nu : 1;
+	for(t = 0; t < nthr; t++){
+		w[t] = w[0];
+		w[t].lo = (int) ((long long) nu * t / nthr) * unit;
+		w[t].hi = (int) ((long long) nu * (t + 1) / nthr) * unit;
+		if(w[t].hi > n) w[t].hi = n;
+		w[t].nd = 0;
+	}
+	for(t = 1; t < nthr; t++)
+		if(pthread_create(&tid[t], NULL, fn, &w[t]) != 0) break;
+	started = t;
+	fn(&w[0]);
+	for(t = started; t < nthr; t++) fn(&w[t]);    /* threads that could not start */
+	for(t = 1; t < started; t++) pthread_join(tid[t], NULL);
+	free(tid);
+}
+
+/* ppsfp() over nthr slices of flist, returns the faults detected */
+int tsim_ppsfp(const CNET *c, const struct pstore *ps, const int *flist, int nf, int *detvec, int nthr)
+{
+	struct twork *w = (struct twork *) calloc(nthr, sizeof(struct twork));
+	int t, nd = 0;
+	w[0].c = c; w[0].ps = ps; w[0].flist = flist; w[0].detvec = detvec;
+	trun(w, nf, 64, nthr, ppsfp_work);
+	for(t = 0; t < nthr; t++) nd += w[t].nd;
+	free(w);
+	return nd;
+}
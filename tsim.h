@@ -0,0 +1,20 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+/*-----------------------------------------------------------------------
+  thread parallel fault grading
+
+  The compiled netlist is only read, every worker owns its value
+  columns, event queue and fault simulator state. DFS and PFS grade
+  chunks of the vector list on the work-stealing pool and share one
+  atomic bitmap of detected faults. PPSFP splits the fault list into
+  contiguous ranges. The results do not depend on the thread count or
+  the scheduling.
+-----------------------------------------------------------------------*/
+
+/*----------------- new function        ----------------------------------*/
+extern int tsim_nthreads(int n);
+extern int tsim_grade(const CNET *c, const struct pstore *ps, int *right, uint64_t *det, int pfs, int nthr);
+extern int tsim_ppsfp(const CNET *c, const struct pstore *ps, const int *flist, int nf, int *detvec, int nthr);
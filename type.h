@@ -3,6 +3,8 @@ Author: zhenyu LI
 Group 7
 ************************/
 
+/* gate types, column 3 of the circuit format */
+enum e_gtype {IPT, BRCH, XOR, OR, NOR, NOT, NAND, AND};
 
 // fault 
 struct fault{
@@ -16,13 +18,6 @@ struct fList{
 	struct fList *next; // next node
 };
 
-// input vector data structure
-struct ipList{
-	int *Nip;  // array of input 
- 	struct fault *fp; // fault detect by this input	
-	struct ipList *next; 
-};
-
 //note: how malloc
 //struct fault *new = (struct fault *)malloc(sizeof(struct fault));
 // free(new) to delete.
@@ -0,0 +1,132 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "wspool.h"
+
+struct wspool {
+	int nthr;
+	struct wsdeque *dq;
+	void (*fn)(void *ctx, int worker, int task);
+	void *ctx;
+};
+
+struct wsarg {
+	struct wspool *p;
+	int id;
+};
+
+/* owner end, -1 when the deque is empty */
+static int wspop(struct wsdeque *d)
+{
+	long b = atomic_load_explicit(&d->bottom, memory_order_relaxed) - 1;
+	long t;
+	int x;
+
+	atomic_store_explicit(&d->bottom, b, memory_order_relaxed);
+	atomic_thread_fence(memory_order_seq_cst);
+	t = atomic_load_explicit(&d->top, memory_order_relaxed);
+	if(t > b){
+		atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+		return -1;
+	}
+	x = d->task[b];
+	if(t == b){     /* last task, race the thieves for it */
+		if(!atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1,
+			memory_order_seq_cst, memory_order_relaxed)) x = -1;
+		atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+	}
+	return x;
+}
+
+/* thief end, -1 when empty or another thief won */
+static int wssteal(struct wsdeque *d)
+{
+	long t = atomic_load_explicit(&d->top, memory_order_acquire);
+	long b;
+	int x;
+
+	atomic_thread_fence(memory_order_seq_cst);
+	b = atomic_load_explicit(&d->bottom, memory_order_acquire);
+	if(t >= b) return -1;
+	x = d->task[t];
+	if(!atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1,
+		memory_order_seq_cst, memory_order_relaxed)) return -2;
+	return x;
+}
+
+static void *wswork(void *arg)
+{
+	struct wsarg *a = (struct wsarg *) arg;
+	struct wspool *p = a->p;
+	unsigned seed = 2463534242u + a->id;
+	int x, k, v, busy;
+
+	for(;;){
+		while((x = wspop(&p->dq[a->id])) >= 0) p->fn(p->ctx, a->id, x);
+		/* steal, starting from a random victim; give up after a sweep
+		   where every deque was empty */
+		do{
+			busy = 0;
+			seed ^= seed << 13; seed ^= seed >> 17; seed ^= seed << 5;
+			for(k = 0, x = -1; k < p->nthr && x < 0; k++){
+				v = (seed + k) % p->nthr;
+				if(v == a->id) continue;
+				x = wssteal(&p->dq[v]);
+				if(x == -2) busy = 1;
+			}
+		}while(x < 0 && busy);
+		if(x < 0) return NULL;
+		p->fn(p->ctx, a->id, x);
+	}
+}
+
+/*-----------------------------------------------------------------------
+input: worker count, task count, task function and its context
+output: nothing
+called by: tsim_grade
+description: run fn(ctx, worker, task) once for every task. Worker 0 is
+  the calling thread; fn may keep per worker state indexed by worker.
+author: Li
+-----------------------------------------------------------------------*/
+void wspool_run(int nthr, int ntask, void (*fn)(void *ctx, int worker, int task), void *ctx)
+{
+	struct wspool p;
+	struct wsarg *a;
+	pthread_t *tid;
+	int t, k, lo, hi, started;
+
+	if(nthr < 1) nthr = 1;
+	p.nthr = nthr;
+	p.fn = fn;
+	p.ctx = ctx;
+	p.dq = (struct wsdeque *) calloc(nthr, sizeof(struct wsdeque));
+	a = (struct wsarg *) malloc(nthr * sizeof(struct wsarg));
+	tid = (pthread_t *) malloc(nthr * sizeof(pthread_t));
+	for(t = 0; t < nthr; t++){
+		lo = (int) ((long long) ntask * t / nthr);
+		hi = (int) ((long long) ntask * (t + 1) / nthr);
+		/* the owner pops from the bottom, so store the block reversed
+		   and it walks its tasks in increasing order */
+		p.dq[t].task = (int *) malloc((hi - lo + 1) * sizeof(int));
+		for(k = 0; k < hi - lo; k++) p.dq[t].task[k] = hi - 1 - k;
+		atomic_init(&p.dq[t].top, 0);
+		atomic_init(&p.dq[t].bottom, hi - lo);
+		a[t].p = &p;
+		a[t].id = t;
+	}
+	for(t = 1; t < nthr; t++)
+		if(pthread_create(&tid[t], NULL, wswork, &a[t]) != 0) break;
+	started = t;
+	wswork(&a[0]);
+	for(t = 1; t < started; t++) pthread_join(tid[t], NULL);
+	/* deques of workers that could not start were emptied by stealing */
+	for(t = 0; t < nthr; t++) free(p.dq[t].task);
+	free(p.dq);
+	free(a);
+	free(tid);
+}
@@ -0,0 +1,26 @@
+/***********************
+Author: zhenyu LI
+Group 7
+************************/
+
+#include <stdatomic.h>
+
+/*-----------------------------------------------------------------------
+  work-stealing task pool
+
+  Tasks are the integers 0..ntask-1. They are dealt out in contiguous
+  blocks to one deque per worker before the workers start. A worker
+  takes tasks from the bottom of its own deque and, once that is empty,
+  steals from the top of a random other deque (Chase-Lev). No task is
+  created while the pool runs, so the deques never grow and the pool is
+  done when a worker finds every deque empty.
+-----------------------------------------------------------------------*/
+struct wsdeque {
+	_Atomic long top;       /* next task to steal */
+	_Atomic long bottom;    /* one past the owner's next task */
+	int *task;
+	char pad[64];           /* keep deques of different workers apart */
+};
+
+/*----------------- new function        ----------------------------------*/
+extern void wspool_run(int nthr, int ntask, void (*fn)(void *ctx, int worker, int task), void *ctx);